@@ -6,6 +6,8 @@
 #include <fstream>
 #include <chrono>
 #include <ctime>
+#include <cstring>
+#include <sstream>
 
 using Clock = chrono::high_resolution_clock;
 
@@ -21,6 +23,9 @@ AlgorithmOutput::AlgorithmOutput(wxWindow* parent) : wxPanel(parent)
 AlgorithmOutput::~AlgorithmOutput()
 {
 	wxDELETE(m_Timer);
+
+	// the last checkpoint is still being written
+	StopCheckpointWriter();
 }
 
 void AlgorithmOutput::SetGrid(Grid* grid)
@@ -63,10 +68,19 @@ void AlgorithmOutput::BuildInterface()
 	m_Save->Disable();
 	m_Save->Bind(wxEVT_BUTTON, &AlgorithmOutput::OnSave, this);
 
+	m_Checkpoint = new wxButton(this, wxID_ANY, "Checkpoint");
+	m_Checkpoint->Disable();
+	m_Checkpoint->Bind(wxEVT_BUTTON, &AlgorithmOutput::OnCheckpoint, this);
+
+	m_Resume = new wxButton(this, wxID_ANY, "Resume");
+	m_Resume->Bind(wxEVT_BUTTON, &AlgorithmOutput::OnResume, this);
+
 	wxBoxSizer* sizerButtons = new wxBoxSizer(wxHORIZONTAL);
 	sizerButtons->Add(m_Start, 0);
 	sizerButtons->Add(m_Stop, 0, wxLEFT | wxRIGHT, 0);
 	sizerButtons->Add(m_Save, 0);
+	sizerButtons->Add(m_Checkpoint, 0, wxLEFT, 16);
+	sizerButtons->Add(m_Resume, 0);
 
 	m_TextEpoch = new wxStaticText(this, wxID_ANY, "Epoch: 0");
 
@@ -74,33 +88,41 @@ void AlgorithmOutput::BuildInterface()
 	m_TextLastAvgPopulation = new wxStaticText(this, wxID_ANY, "0");
 	m_TextLastInitialSize = new wxStaticText(this, wxID_ANY, "0");
 	m_TextLastFitness = new wxStaticText(this, wxID_ANY, "0");
+	m_TextLastPeriod = new wxStaticText(this, wxID_ANY, "0");
 
 	m_TextBestNofGeneration = new wxStaticText(this, wxID_ANY, "0");
 	m_TextBestAvgPopulation = new wxStaticText(this, wxID_ANY, "0");
 	m_TextBestInitialSize = new wxStaticText(this, wxID_ANY, "0");
 	m_TextBestFitness = new wxStaticText(this, wxID_ANY, "0");
+	m_TextBestPeriod = new wxStaticText(this, wxID_ANY, "0");
 
-	wxFlexGridSizer* sizerLast = new wxFlexGridSizer(2, 4, wxSize(24, 0));
+	wxFlexGridSizer* sizerLast = new wxFlexGridSizer(2, 5, wxSize(24, 0));
 	sizerLast->Add(new wxStaticText(this, wxID_ANY, "Last No. Generations"), 0, wxALIGN_RIGHT);
 	sizerLast->Add(new wxStaticText(this, wxID_ANY, "Last Avg. Population"), 0, wxALIGN_RIGHT);
 	sizerLast->Add(new wxStaticText(this, wxID_ANY, "Last Initial Size"), 0, wxALIGN_RIGHT);
 	sizerLast->Add(new wxStaticText(this, wxID_ANY, "Last Fitness"), 0, wxALIGN_RIGHT);
+	sizerLast->Add(new wxStaticText(this, wxID_ANY, "Last Period"), 0, wxALIGN_RIGHT);
 	sizerLast->Add(m_TextLastNofGeneration, 0, wxALIGN_RIGHT);
 	sizerLast->Add(m_TextLastAvgPopulation, 0, wxALIGN_RIGHT);
 	sizerLast->Add(m_TextLastInitialSize, 0, wxALIGN_RIGHT);
 	sizerLast->Add(m_TextLastFitness, 0, wxALIGN_RIGHT);
+	sizerLast->Add(m_TextLastPeriod, 0, wxALIGN_RIGHT);
 
-	wxFlexGridSizer* sizerBest = new wxFlexGridSizer(2, 4, wxSize(24, 0));
+	wxFlexGridSizer* sizerBest = new wxFlexGridSizer(2, 5, wxSize(24, 0));
 	sizerBest->Add(new wxStaticText(this, wxID_ANY, "Best No. Generations"), 0, wxALIGN_RIGHT);
 	sizerBest->Add(new wxStaticText(this, wxID_ANY, "Best Avg. Population"), 0, wxALIGN_RIGHT);
 	sizerBest->Add(new wxStaticText(this, wxID_ANY, "Best Initial Size"), 0, wxALIGN_RIGHT);
 	sizerBest->Add(new wxStaticText(this, wxID_ANY, "Best Fitness"), 0, wxALIGN_RIGHT);
+	sizerBest->Add(new wxStaticText(this, wxID_ANY, "Best Period"), 0, wxALIGN_RIGHT);
 	sizerBest->Add(m_TextBestNofGeneration, 0, wxALIGN_RIGHT);
 	sizerBest->Add(m_TextBestAvgPopulation, 0, wxALIGN_RIGHT);
 	sizerBest->Add(m_TextBestInitialSize, 0, wxALIGN_RIGHT);
 	sizerBest->Add(m_TextBestFitness, 0, wxALIGN_RIGHT);
+	sizerBest->Add(m_TextBestPeriod, 0, wxALIGN_RIGHT);
 
 	m_TextElapsed = new wxStaticText(this, wxID_ANY, "Time Elapsed: 00:00:00");
+	m_TextCache = new wxStaticText(this, wxID_ANY, "Cache Hits: 0.0% (0 of 0)");
+	m_TextCheckpoint = new wxStaticText(this, wxID_ANY, "Last Checkpoint: None");
 
 	wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
 	sizer->Add(sizerButtons, 0);
@@ -112,23 +134,30 @@ void AlgorithmOutput::BuildInterface()
 	sizer->Add(sizerBest, 0);
 	sizer->AddSpacer(8);
 	sizer->Add(m_TextElapsed, 0);
+	sizer->AddSpacer(8);
+	sizer->Add(m_TextCache, 0);
+	sizer->AddSpacer(8);
+	sizer->Add(m_TextCheckpoint, 0);
 
 	SetSizerAndFit(sizer);
 }
 
 void AlgorithmOutput::RunAlgorithm()
 {
+	// taken right away, so the next start isn't a resume as well
+	unique_ptr<Checkpoint> resumeFrom = move(m_ResumeFrom);
+
 	// get CA configuration -> as simple vectors
 	m_States = m_InputStates->GetList()->GetStates();
 	m_Rules = m_InputRules->GetList()->GetRules();
 	m_Neighbors = m_InputNeighbors->GetNeighborsAsVector();
 
 	// get CA configuration -> as used in playing the simulations
-	unordered_map<string, string> states = m_InputStates->GetStates();
-	vector<pair<string, Transition>> rules = m_InputRules->GetRules();
-	unordered_set<string> neighbors = m_InputNeighbors->GetNeighbors();
+	// (its own rule set: the states are interned in the order of the list, so every gene is also a state id)
+	m_Registry = StateRegistry(m_States);
+	m_RuleSet = make_shared<const RuleSet>(m_InputRules->GetRules(), m_States, m_InputNeighbors->GetNeighbors(), m_Registry);
 
-	if (states.size() <= 1 || rules.size() == 0)
+	if (m_States.size() <= 1 || m_RuleSet->GetRules().size() == 0)
 	{
 		wxRichMessageDialog dialog(
 			this, "No cellular automaton detected.", "Error",
@@ -140,14 +169,13 @@ void AlgorithmOutput::RunAlgorithm()
 		return;
 	}
 
-	string errors = CheckValidAutomaton(states, rules, neighbors);
-	if (errors.size())
+	if (m_RuleSet->GetError().size())
 	{
 		wxRichMessageDialog dialog(
 			this, "Some of the rules appear to be invalid.", "Error",
 			wxOK | wxICON_ERROR
 		);
-		dialog.ShowDetailedText(errors);
+		dialog.ShowDetailedText(m_RuleSet->GetError() + " at rule number " + to_string(m_RuleSet->GetErrorRule() + 1));
 		dialog.ShowModal();
 
 		EndAlgorithm(false);
@@ -156,58 +184,444 @@ void AlgorithmOutput::RunAlgorithm()
 
 	GetParameters();
 
-	generator.seed(Clock::now().time_since_epoch().count());
+	if (topology == TOPOLOGY_BORDER && border == STATE_INVALID)
+	{
+		wxRichMessageDialog dialog(
+			this, "The state of the grid's border isn't a state of the automaton.", "Error",
+			wxOK | wxICON_ERROR
+		);
+		dialog.ShowModal();
+
+		EndAlgorithm(false);
+		return;
+	}
+
+	// the results depend on the parameters as well -> nothing is kept from the last run
+	m_FitnessCache.Clear(FITNESS_CACHE_SIZE);
 
-	UpdateTextEpoch(0);
+	// picked up from a checkpoint -> with the parameters, the populations and the random numbers it was made with
+	if (resumeFrom)
+	{
+		string error = ResumeCheckpoint(*resumeFrom);
+
+		if (error.size())
+		{
+			wxRichMessageDialog dialog(
+				this, "The checkpoint can't be resumed.", "Error",
+				wxOK | wxICON_ERROR
+			);
+			dialog.ShowDetailedText(error);
+			dialog.ShowModal();
+
+			EndAlgorithm(false);
+			return;
+		}
+	}
+	else
+	{
+		m_BestChromosome = Chromosome();
+
+		// every island gets its own stream of random numbers
+		unsigned long long seed = Clock::now().time_since_epoch().count();
+
+		m_Islands = vector<Island>(nIslands);
+		m_IslandEpochs.assign(nIslands, 0);
+		for (int i = 0; i < nIslands; i++)
+		{
+			seed_seq seq{ (unsigned int)seed, (unsigned int)(seed >> 32), (unsigned int)i };
+			m_Islands[i].generator.seed(seq);
+		}
+	}
+
+	for (auto& island : m_Islands) island.mailbox.Resize(nIslands);
+
+	UpdateTextEpoch(*min_element(m_IslandEpochs.begin(), m_IslandEpochs.end()));
+	UpdateTextCache();
 
-	m_BestChromosome = Chromosome();
 	UpdateTextLast(m_BestChromosome);
 	UpdateTextBest(m_BestChromosome);
 
-	// I. create an initial population of chromosomes
-	vector<Chromosome> population = InitializePopulation();
-	EvaluatePopulation(population, states, rules, neighbors);
+	// what every checkpoint of this run is made with (a resumed one starts with the islands it was picked up from)
+	m_NextCheckpoint = Checkpoint();
+	m_NextCheckpoint.states = m_States;
+	m_NextCheckpoint.rules = m_Rules;
+	m_NextCheckpoint.neighbors = m_Neighbors;
+	m_NextCheckpoint.rows = rows;
+	m_NextCheckpoint.cols = cols;
+	m_NextCheckpoint.topology = topology;
+	m_NextCheckpoint.border = border;
+	m_NextCheckpoint.popSize = popSize;
+	m_NextCheckpoint.pc = pc;
+	m_NextCheckpoint.pm = pm;
+	m_NextCheckpoint.generationMultiplier = generationMultiplier;
+	m_NextCheckpoint.populationMultiplier = populationMultiplier;
+	m_NextCheckpoint.initialSizeMultiplier = initialSizeMultiplier;
+	m_NextCheckpoint.epochsTarget = epochsTarget;
+	m_NextCheckpoint.generationTarget = generationTarget;
+	m_NextCheckpoint.populationTarget = populationTarget;
+	m_NextCheckpoint.periodLimit = periodLimit;
+	m_NextCheckpoint.migrationInterval = migrationInterval;
+	m_NextCheckpoint.nMigrants = nMigrants;
+	m_NextCheckpoint.checkpointInterval = checkpointInterval;
+	m_NextCheckpoint.migrationTopology = migrationTopology.ToStdString();
+	m_NextCheckpoint.selectionMethod = selectionMethod.ToStdString();
+	m_NextCheckpoint.islands = resumeFrom ? resumeFrom->islands : vector<Checkpoint::Island>(nIslands);
+
+	m_CheckpointTaken.assign(nIslands, false);
+	{
+		lock_guard<mutex> lock(m_MutexCheckpoint);
+		m_CheckpointRequested.assign(nIslands, false);
+		m_CheckpointQueued.reset();
+		m_CheckpointWriterStop = false;
+	}
+
+	m_CheckpointWriter = thread(&AlgorithmOutput::WriteCheckpoints, this);
 
-	Chromosome bestChromosome = GetBestChromosome(population, 0);
-	m_BestChromosome = bestChromosome;
+	// every island runs on a thread of its own, the pool only evaluates their chromosomes: an island
+	// can run until it's stopped, so on the pool the ones past its size would never get their turn
+	vector<thread> islandThreads;
+	for (int i = 1; i < nIslands; i++) islandThreads.push_back(thread(&AlgorithmOutput::RunIsland, this, i));
 
-	UpdateTextLast(bestChromosome);
-	UpdateTextBest(bestChromosome);
+	RunIsland(0);
+
+	for (auto& islandThread : islandThreads) islandThread.join();
+
+	// stopped -> the islands are kept as they were left, so the run can be picked up from there
+	// (the ones stopped while making a population as they were at their last checkpoint)
+	if (!m_Running)
+	{
+		lock_guard<mutex> lock(m_MutexReport);
+
+		wxString path;
+		{
+			lock_guard<mutex> lockCheckpoint(m_MutexCheckpoint);
+			path = m_CheckpointPath;
+		}
+
+		bool complete = true;
+		for (int i = 0; i < nIslands; i++)
+		{
+			if (m_Islands[i].intact) CaptureIsland(i);
+			if (m_NextCheckpoint.islands[i].population.empty()) complete = false;
+		}
+
+		if (path.size() && complete) WriteCheckpoint(path);
+		else if (path.size())
+		{
+			lock_guard<mutex> lockCheckpoint(m_MutexCheckpoint);
+			m_CheckpointStatus = "Last Checkpoint: Skipped (stopped before the first population was made)";
+		}
+	}
+
+	EndAlgorithm();
+}
+
+void AlgorithmOutput::RunIsland(int i)
+{
+	Island& island = m_Islands[i];
+
+	// I. create an initial population of chromosomes (unless it was picked up from a checkpoint)
+	if (island.population.empty())
+	{
+		island.population = InitializePopulation(island);
+
+		if (!m_Running)
+		{
+			island.intact = false;
+			return;
+		}
+	}
 
 	// run the algorithm until the desired epoch target is hit
 	// or until explicitely stopped
-	int epochs = 0;
-	while (++epochs && m_Running)
+	while (m_Running)
 	{
-		UpdateTextEpoch(epochs);
+		if (island.evaluated)
+		{
+			// (0 -> no target)
+			if (island.epoch == epochsTarget && epochsTarget) break;
+
+			island.epoch++;
+			island.evaluated = false;
 
-		// II. select which chromosomes will make up the next population
-		population = SelectPopulation(population);
+			// II. select which chromosomes will make up the next population (only their indexes)
+			vector<int> parents = SelectPopulation(island);
 
-		// III. apply genetic operators on the new population
-		// don't do crossover on SteadyState - it has its own version
-		if (selectionMethod != "Steady State") population = DoCrossover(population);
-		DoMutatiton(population);
+			// III. apply genetic operators on the new population
+			// (SteadyState has its own version of the crossover, see DoCrossover)
+			island.population = DoCrossover(island, parents);
+			DoMutatiton(island);
 
-		UpdateChromosomesMaps(population);
+			// stopped halfway through
+			if (!m_Running)
+			{
+				island.intact = false;
+				break;
+			}
+		}
 
 		// IV. evaluate and save the best chromosome of this generation
-		EvaluatePopulation(population, states, rules, neighbors);
+		// (if it's stopped in the meantime, the population is evaluated again once it's picked up)
+		EvaluatePopulation(island);
+		if (!m_Running) break;
 
-		bestChromosome = GetBestChromosome(population, epochs);
-		UpdateTextLast(bestChromosome);
+		island.evaluated = true;
 
-		// update best chromosome of all generations
-		if (bestChromosome > m_BestChromosome)
-		{
-			m_BestChromosome = bestChromosome;
-			UpdateTextBest(bestChromosome);
-		}
+		// V. trade the best chromosomes with the other islands
+		if (nIslands > 1 && island.epoch) Migrate(i, island.epoch);
+
+		ReportEpoch(i, island.epoch);
 
-		if (epochs == epochsTarget) break;
+		// VI. keep all of it on the disk, every few epochs or when asked for
+		CheckpointIsland(i);
 	}
+}
 
-	EndAlgorithm();
+void AlgorithmOutput::Migrate(int i, int epoch)
+{
+	Island& island = m_Islands[i];
+	vector<Chromosome>& population = island.population;
+
+	// sorted from worst to best, without moving the chromosomes
+	vector<int> indexes(population.size());
+	for (int k = 0; k < indexes.size(); k++) indexes[k] = k;
+
+	sort(indexes.begin(), indexes.end(), [&population](int a, int b) { return population[a].fitness < population[b].fitness; });
+
+	// the migrants that arrived since the last epoch take the place of the worst chromosomes
+	// (at most half of them, the population is still mostly the island's own)
+	vector<Mailbox::Migrant> migrants = island.mailbox.Receive();
+
+	int nArrived = min<int>(migrants.size(), population.size() / 2);
+	for (int k = 0; k < nArrived; k++)
+	{
+		Chromosome& chromosome = population[indexes[k]];
+		int slot = chromosome.id;
+
+		memcpy(island.genes.Get(slot), migrants[k].genes.data(), rows * cols);
+
+		chromosome = migrants[k].chromosome;
+		chromosome.id = slot;
+	}
+
+	if (epoch % migrationInterval) return;
+
+	// copies of the best ones (the ones that just arrived included) are sent to the next island,
+	// or to every other one when they're all connected
+	vector<Mailbox::Migrant> elites;
+	for (int k = (int)indexes.size() - 1; k >= 0 && elites.size() < nMigrants; k--)
+	{
+		Chromosome& chromosome = population[indexes[k]];
+		const uint8_t* genes = island.genes.Get(chromosome.id);
+
+		elites.push_back({ chromosome, vector<uint8_t>(genes, genes + rows * cols) });
+	}
+
+	for (int j = 0; j < nIslands; j++)
+	{
+		if (j == i) continue;
+		if (migrationTopology == "Ring" && j != (i + 1) % nIslands) continue;
+
+		m_Islands[j].mailbox.Send(i, new vector<Mailbox::Migrant>(elites));
+	}
+}
+
+void AlgorithmOutput::ReportEpoch(int i, int epoch)
+{
+	Island& island = m_Islands[i];
+
+	Chromosome bestChromosome = GetBestChromosome(island.population, epoch);
+
+	lock_guard<mutex> lock(m_MutexReport);
+
+	// the islands don't wait for each other -> the epoch every one of them got past
+	m_IslandEpochs[i] = epoch;
+	UpdateTextEpoch(*min_element(m_IslandEpochs.begin(), m_IslandEpochs.end()));
+	UpdateTextCache();
+
+	UpdateTextLast(bestChromosome);
+
+	// update best chromosome of all generations
+	if (bestChromosome > m_BestChromosome)
+	{
+		SetBestChromosome(island, bestChromosome);
+		UpdateTextBest(bestChromosome);
+	}
+}
+
+string AlgorithmOutput::ResumeCheckpoint(const Checkpoint& checkpoint)
+{
+	// the automaton has to be the one it was made for, and so does the grid
+	if (checkpoint.states != m_States || checkpoint.rules != m_Rules || checkpoint.neighbors != m_Neighbors)
+	{
+		return "It was made for another cellular automaton";
+	}
+
+	if (checkpoint.rows != rows || checkpoint.cols != cols)
+	{
+		return "It was made for a grid of " + to_string(checkpoint.rows) + "x" + to_string(checkpoint.cols) + " cells";
+	}
+
+	if (checkpoint.topology != topology || checkpoint.border != border)
+	{
+		return "It was made for other edges of the grid";
+	}
+
+	// the parameters it was made with, not the ones set right now
+	popSize = checkpoint.popSize;
+	pc = checkpoint.pc;
+	pm = checkpoint.pm;
+	generationMultiplier = checkpoint.generationMultiplier;
+	populationMultiplier = checkpoint.populationMultiplier;
+	initialSizeMultiplier = checkpoint.initialSizeMultiplier;
+	epochsTarget = checkpoint.epochsTarget;
+	generationTarget = checkpoint.generationTarget;
+	populationTarget = checkpoint.populationTarget;
+	periodLimit = checkpoint.periodLimit;
+	nIslands = checkpoint.islands.size();
+	migrationInterval = checkpoint.migrationInterval;
+	nMigrants = checkpoint.nMigrants;
+	checkpointInterval = checkpoint.checkpointInterval;
+	migrationTopology = checkpoint.migrationTopology;
+	selectionMethod = checkpoint.selectionMethod;
+
+	m_Islands = vector<Island>(nIslands);
+	m_IslandEpochs.assign(nIslands, 0);
+	for (int i = 0; i < nIslands; i++)
+	{
+		Island& island = m_Islands[i];
+		const Checkpoint::Island& saved = checkpoint.islands[i];
+
+		istringstream generator(saved.generator);
+		generator >> island.generator;
+
+		if (generator.fail()) return "The random numbers of island " + to_string(i + 1) + " can't be restored";
+
+		// the ids and the genes were checked when it was read
+		island.population = saved.population;
+
+		island.genes.Resize(popSize, rows * cols);
+		island.nextGenes.Resize(popSize, rows * cols);
+		memcpy(island.genes.Get(0), saved.genes.data(), saved.genes.size());
+
+		island.epoch = saved.epoch;
+		island.evaluated = saved.evaluated;
+		m_IslandEpochs[i] = saved.epoch;
+	}
+
+	m_BestChromosome = checkpoint.bestChromosome;
+	m_BestGenes = checkpoint.bestGenes;
+
+	if (m_BestGenes.size() != rows * cols) m_BestChromosome = Chromosome();
+
+	return "";
+}
+
+void AlgorithmOutput::CaptureIsland(int i)
+{
+	Island& island = m_Islands[i];
+	Checkpoint::Island& captured = m_NextCheckpoint.islands[i];
+
+	captured.epoch = island.epoch;
+	captured.evaluated = island.evaluated;
+
+	ostringstream generator;
+	generator << island.generator;
+	captured.generator = generator.str();
+
+	captured.population = island.population;
+
+	const uint8_t* genes = island.genes.Get(0);
+	captured.genes.assign(genes, genes + (size_t)popSize * rows * cols);
+}
+
+void AlgorithmOutput::CheckpointIsland(int i)
+{
+	lock_guard<mutex> lock(m_MutexReport);
+
+	bool due = checkpointInterval && m_Islands[i].epoch % checkpointInterval == 0;
+
+	wxString path;
+	{
+		lock_guard<mutex> lockCheckpoint(m_MutexCheckpoint);
+
+		if (m_CheckpointRequested[i]) due = true;
+		m_CheckpointRequested[i] = false;
+
+		path = m_CheckpointPath;
+	}
+
+	if (!due || path.empty()) return;
+
+	CaptureIsland(i);
+	m_CheckpointTaken[i] = true;
+
+	// written once every island is in it (the islands don't wait for each other, so some of them
+	// might be a few epochs ahead, a checkpoint is only where every one of them got to)
+	if (find(m_CheckpointTaken.begin(), m_CheckpointTaken.end(), false) != m_CheckpointTaken.end()) return;
+
+	m_CheckpointTaken.assign(nIslands, false);
+	WriteCheckpoint(path);
+}
+
+void AlgorithmOutput::WriteCheckpoint(const wxString& path)
+{
+	// a copy of it, the islands go on while it's written
+	shared_ptr<Checkpoint> checkpoint = make_shared<Checkpoint>(m_NextCheckpoint);
+	checkpoint->timeElapsed = max(0, m_TimeElapsed.load());
+	checkpoint->bestChromosome = m_BestChromosome;
+	checkpoint->bestGenes = m_BestGenes;
+
+	// the islands never wait for the file: only the newest checkpoint waiting is written
+	lock_guard<mutex> lock(m_MutexCheckpoint);
+
+	m_CheckpointQueued = checkpoint;
+	m_CheckpointQueuedPath = path.ToStdString();
+
+	m_CheckpointWake.notify_one();
+}
+
+void AlgorithmOutput::WriteCheckpoints()
+{
+	unique_lock<mutex> lock(m_MutexCheckpoint);
+
+	while (true)
+	{
+		m_CheckpointWake.wait(lock, [this] { return m_CheckpointQueued || m_CheckpointWriterStop; });
+
+		// stopped, with nothing left to write
+		if (!m_CheckpointQueued) return;
+
+		shared_ptr<Checkpoint> checkpoint = move(m_CheckpointQueued);
+		m_CheckpointQueued.reset();
+		string path = m_CheckpointQueuedPath;
+
+		lock.unlock();
+
+		string error = checkpoint->Write(path);
+
+		int epoch = checkpoint->islands[0].epoch;
+		for (auto& island : checkpoint->islands) epoch = min(epoch, island.epoch);
+
+		lock.lock();
+
+		if (error.size()) m_CheckpointStatus = wxString::Format("Last Checkpoint: Failed (%s)", error);
+		else m_CheckpointStatus = wxString::Format("Last Checkpoint: Epoch %i", epoch);
+	}
+}
+
+void AlgorithmOutput::StopCheckpointWriter()
+{
+	if (!m_CheckpointWriter.joinable()) return;
+
+	// whatever is still waiting gets written first
+	{
+		lock_guard<mutex> lock(m_MutexCheckpoint);
+		m_CheckpointWriterStop = true;
+	}
+	m_CheckpointWake.notify_one();
+
+	m_CheckpointWriter.join();
 }
 
 void AlgorithmOutput::GetParameters()
@@ -215,6 +629,10 @@ void AlgorithmOutput::GetParameters()
 	rows = Sizes::N_ROWS;
 	cols = Sizes::N_COLS;
 
+	// the patterns run with the same edges as the grid
+	topology = m_Grid->GetTopology();
+	border = topology == TOPOLOGY_BORDER ? m_Registry.Find(m_Grid->GetBorder()) : STATE_FREE;
+
 	popSize = m_AlgorithmParameters->GetPopulationSize();
 	pc = m_AlgorithmParameters->GetProbabilityCrossover();
 	pm = m_AlgorithmParameters->GetProbabilityMutation();
@@ -227,52 +645,55 @@ void AlgorithmOutput::GetParameters()
 	generationTarget = m_AlgorithmParameters->GetGenerationTarget();
 	populationTarget = m_AlgorithmParameters->GetPopulationTarget();
 	epochsTarget = m_AlgorithmParameters->GetEpochsTarget();
+	periodLimit = m_AlgorithmParameters->GetPeriodLimit();
+
+	// the population is split evenly between the islands (every one of them needs a couple of parents at least)
+	nIslands = max(1, min(m_AlgorithmParameters->GetIslands(), popSize / 2));
+	popSize /= nIslands;
+	migrationInterval = m_AlgorithmParameters->GetMigrationInterval();
+	nMigrants = m_AlgorithmParameters->GetMigrants();
+	migrationTopology = m_AlgorithmParameters->GetMigrationTopology();
+
+	checkpointInterval = m_AlgorithmParameters->GetCheckpointInterval();
 }
 
-vector<Chromosome> AlgorithmOutput::InitializePopulation()
+vector<Chromosome> AlgorithmOutput::InitializePopulation(Island& island)
 {
 	// a chromosome is denoted by a vector of states (expressed as numbers)
 	// return a list of randomly created chromosomes of the desired population size
 
 	vector<Chromosome> population;
 
+	// the genes of every chromosome are kept in the gene pool, the chromosomes only know their slot
+	island.genes.Resize(popSize, rows * cols);
+	island.nextGenes.Resize(popSize, rows * cols);
+
 	uniform_real_distribution<double> r01(0, 1);
 	uniform_int_distribution<int> i1n(1, m_States.size() - 1);
 
 	for (int i = 0; i < popSize && m_Running; i++)
 	{
-		double cellProbability = r01(generator);
+		double cellProbability = r01(island.generator);
 
-		vector<int> pattern(rows * cols);
-		unordered_map<int, string> cells;
-		unordered_map<string, unordered_set<int>> statePositions;
+		uint8_t* genes = island.genes.Get(i);
 		int initialSize = 0;
 
 		// create random genes for the current chromosome
 		for (int j = 0; j < rows * cols && m_Running; j++)
 		{
-			double p = r01(generator);
+			double p = r01(island.generator);
 
 			if (p <= cellProbability)
 			{
 				// assign a random state for this gene
-				int cellType = i1n(generator);
-
-				pattern[j] = cellType;
+				genes[j] = i1n(island.generator);
 				initialSize++;
-
-				cells[j] = m_States[cellType];
-				statePositions[m_States[cellType]].insert(j);
 			}
 		}
 
 		Chromosome chromosome;
 		chromosome.id = i;
-		chromosome.pattern = pattern;
-		chromosome.initialPattern = pattern;
 		chromosome.initialSize = initialSize;
-		chromosome.cells = cells;
-		chromosome.statePositions = statePositions;
 		chromosome.nOfGenerations = 0;
 		chromosome.avgPopulation = 0;
 		chromosome.fitness = 1.0;
@@ -283,70 +704,177 @@ vector<Chromosome> AlgorithmOutput::InitializePopulation()
 	return population;
 }
 
-void AlgorithmOutput::EvaluatePopulation(vector<Chromosome>& population, unordered_map<string, string>& states,
-	vector<pair<string, Transition>>& rules, unordered_set<string>& neighbors)
+void AlgorithmOutput::EvaluatePopulation(Island& island)
 {
 	// calculate and store the fitness for every chromosome
 	// to get the fitness, play out the simulation for each chromosome
 
-	// iterate through the chromosomes
-	for (int i = 0; i < popSize && m_Running; i++)
+	// the chromosomes don't depend on each other -> every thread takes the next one left and writes
+	// its results in place, so they're the same as when evaluated one after another
+	// (the islands share the threads, each of them gets its part)
+	int nThreads = m_ThreadPool.GetSize() + 1;
+	int nEvaluators = min<int>(popSize, (nThreads + nIslands - 1) / nIslands);
+	if (island.evaluators.size() < nEvaluators)
+	{
+		island.evaluators.resize(nEvaluators);
+
+		// a generation is left halfway when the algorithm is stopped
+		for (auto& evaluator : island.evaluators) evaluator.engine.SetStop([this]() { return !m_Running; });
+	}
+
+	atomic<int> next{ 0 };
+	m_ThreadPool.For(nEvaluators, bind(&AlgorithmOutput::EvaluateChromosomes, this, placeholders::_1, ref(island), ref(next)));
+}
+
+void AlgorithmOutput::EvaluateChromosomes(int e, Island& island, atomic<int>& next)
+{
+	// only one thread at a time runs with evaluator e
+	Evaluator& evaluator = island.evaluators[e];
+
+	for (int i = next++; i < popSize && m_Running; i = next++) EvaluateChromosome(island.population[i], island.genes, evaluator);
+}
+
+void AlgorithmOutput::EvaluateChromosome(Chromosome& chromosome, const GenePool& pool, Evaluator& evaluator)
+{
+	const uint8_t* genes = pool.Get(chromosome.id);
+
+	// the same pattern always plays out the same way
+	FitnessCache::Key key = FitnessCache::GetKey(genes, rows * cols);
+	FitnessCache::Entry entry;
+
+	if (m_FitnessCache.Find(key, entry))
+	{
+		chromosome.nOfGenerations = entry.nOfGenerations;
+		chromosome.avgPopulation = entry.avgPopulation;
+		chromosome.initialSize = entry.initialSize;
+		chromosome.period = entry.period;
+		chromosome.transient = entry.transient;
+		chromosome.fitness = entry.fitness;
+
+		return;
+	}
+
+	// the cells are only built for the chromosome being played out, from its genes
+	Universe& cells = evaluator.cells;
+	if (cells.GetRows() != rows || cells.GetCols() != cols) cells.Resize(rows, cols);
+	else cells.Clear();
+	cells.SetTopology(topology, border);
+
+	int initialSize = 0;
+
+	for (int k = 0; k < rows * cols; k++)
+	{
+		if (!genes[k]) continue;
+
+		cells.Set(k, genes[k]);
+		initialSize++;
+	}
+
+	chromosome.initialSize = initialSize;
+	chromosome.period = 0;
+	chromosome.transient = 0;
+
+	// a pattern that comes back to one of the last periodLimit generations
+	// repeats them forever -> there's nothing new to play out
+	evaluator.history.clear();
+	evaluator.historyGenerations.clear();
+	if (periodLimit)
+	{
+		evaluator.history.push_back(cells.GetHash());
+		evaluator.historyGenerations[cells.GetHash()] = 0;
+	}
+
+	// run the simulation for the current chromosome and store the results
+	int nOfGenerations = 0;
+	double avgPopulation = 0;
+	while (++nOfGenerations && m_Running)
 	{
-		population[i].pattern = population[i].initialPattern;
+		// the chromosomes already keep every thread busy -> a single band of rows
+		evaluator.engine.Step(*m_RuleSet, cells, m_ThreadPool, 1, evaluator.changes);
+
+		if (!m_Running) break;
+
+		UpdateGeneration(evaluator);
+
+		// still life
+		if (evaluator.changes.empty())
+		{
+			chromosome.period = 1;
+			chromosome.transient = nOfGenerations - 1;
+
+			break;
+		}
 
-		// run the simulation for the current chromosome and store the results
-		int nOfGenerations = 0;
-		double avgPopulation = 0;
-		while (++nOfGenerations && m_Running)
+		if (periodLimit)
 		{
-			pair<vector<pair<string, pair<int, int>>>, string> result =
-				ParseAllRules(population[i].cells, population[i].statePositions, states, rules, neighbors);
+			unsigned long long hash = cells.GetHash();
 
-			if (result.second.size())
+			auto seen = evaluator.historyGenerations.find(hash);
+			if (seen != evaluator.historyGenerations.end())
 			{
+				chromosome.period = nOfGenerations - seen->second;
+				chromosome.transient = seen->second;
+
 				break;
 			}
 
-			UpdateGeneration(result.first, population[i].pattern, population[i].cells, population[i].statePositions);
+			evaluator.history.push_back(hash);
+			evaluator.historyGenerations[hash] = nOfGenerations;
 
-			if (result.first.empty())
+			if (evaluator.history.size() > periodLimit)
 			{
-				break;
+				evaluator.historyGenerations.erase(evaluator.history.front());
+				evaluator.history.pop_front();
 			}
+		}
 
-			avgPopulation += population[i].cells.size();
+		avgPopulation += cells.GetPopulation();
 
-			// any targets reached?
-			if (generationTarget && nOfGenerations - 1 >= generationTarget) break;
-			if (populationTarget && population[i].cells.size() >= populationTarget) break;
-		}
-		nOfGenerations--;
+		// any targets reached?
+		if (generationTarget && nOfGenerations - 1 >= generationTarget) break;
+		if (populationTarget && cells.GetPopulation() >= populationTarget) break;
+	}
+	// the generation that stopped the loop doesn't count: in a cycle, it's the one repeating an earlier generation
+	nOfGenerations--;
 
-		if (nOfGenerations) avgPopulation /= nOfGenerations;
-		population[i].nOfGenerations = nOfGenerations;
-		population[i].avgPopulation = ceil(avgPopulation);
+	if (nOfGenerations) avgPopulation /= nOfGenerations;
+	chromosome.nOfGenerations = nOfGenerations;
+	chromosome.avgPopulation = ceil(avgPopulation);
 
-		// calculate fitness
-		double fitness = (generationMultiplier * nOfGenerations + populationMultiplier * avgPopulation) * (1 - initialSizeMultiplier * population[i].initialSize / (rows * cols)) + 1.0;
+	// calculate fitness
+	double fitness = (generationMultiplier * nOfGenerations + populationMultiplier * avgPopulation) * (1 - initialSizeMultiplier * chromosome.initialSize / (rows * cols)) + 1.0;
 
-		population[i].fitness = fitness;
-	}
+	chromosome.fitness = fitness;
+
+	// stopped halfway -> these aren't its results
+	if (!m_Running) return;
+
+	entry.nOfGenerations = chromosome.nOfGenerations;
+	entry.avgPopulation = chromosome.avgPopulation;
+	entry.initialSize = chromosome.initialSize;
+	entry.period = chromosome.period;
+	entry.transient = chromosome.transient;
+	entry.fitness = chromosome.fitness;
+
+	m_FitnessCache.Insert(key, entry);
 }
 
-vector<Chromosome> AlgorithmOutput::SelectPopulation(vector<Chromosome>& population)
+vector<int> AlgorithmOutput::SelectPopulation(Island& island)
 {
-	if (selectionMethod == "Roulette Wheel") return RouletteWheelSelection(population);
-	if (selectionMethod == "Rank") return RankSelection(population);
-	if (selectionMethod == "Steady State") return SteadyStateSelection(population);
-	if (selectionMethod == "Tournament") return TournamentSelection(population);
-	if (selectionMethod == "Elitism") return ElitismSelection(population);
-	if (selectionMethod == "Random") return RandomSelection(population);
-
-	return population;
+	if (selectionMethod == "Roulette Wheel") return RouletteWheelSelection(island);
+	if (selectionMethod == "Rank") return RankSelection(island);
+	if (selectionMethod == "Steady State") return SteadyStateSelection(island);
+	if (selectionMethod == "Tournament") return TournamentSelection(island);
+	if (selectionMethod == "Elitism") return ElitismSelection(island);
+	if (selectionMethod == "Random") return RandomSelection(island);
+
+	return ElitismSelection(island);
 }
 
-vector<Chromosome> AlgorithmOutput::RouletteWheelSelection(vector<Chromosome>& population)
+vector<int> AlgorithmOutput::RouletteWheelSelection(Island& island)
 {
+	vector<Chromosome>& population = island.population;
+
 	double totalFitness = 0.0;
 	for (int i = 0; i < popSize; i++) totalFitness += population[i].fitness;
 
@@ -361,7 +889,7 @@ vector<Chromosome> AlgorithmOutput::RouletteWheelSelection(vector<Chromosome>& p
 
 	uniform_real_distribution<double> r01(0, 1);
 
-	vector<Chromosome> newPopulation;
+	vector<int> parents;
 	int j = 0;
 
 	// "spin" the wheel until we have selected enough parents
@@ -370,28 +898,27 @@ vector<Chromosome> AlgorithmOutput::RouletteWheelSelection(vector<Chromosome>& p
 		// iterate through each chromosome
 		for (int i = 0; i < popSize && m_Running; i++)
 		{
-			double p = r01(generator);
+			double p = r01(island.generator);
 
 			// select for the next generation
 			if (q[j] < p && p <= q[j + 1])
 			{
 				j++;
 
-				Chromosome chromosome = population[i];
-				chromosome.id = j;
-
-				newPopulation.push_back(chromosome);
+				parents.push_back(i);
 
 				if (j == popSize) break;
 			}
 		}
 	}
 	
-	return newPopulation;
+	return parents;
 }
 
-vector<Chromosome> AlgorithmOutput::RankSelection(vector<Chromosome>& population)
+vector<int> AlgorithmOutput::RankSelection(Island& island)
 {
+	vector<Chromosome>& population = island.population;
+
 	// sort by fitness, worst to best
 	// now each chromosome is ranked accordingly, from 1 (the worst) to N (the best)
 	sort(population.begin(), population.end());
@@ -410,137 +937,61 @@ vector<Chromosome> AlgorithmOutput::RankSelection(vector<Chromosome>& population
 	uniform_real_distribution<double> r01(0, 1);
 
 	// apply this selection method until we have selected enough parents
-	vector<Chromosome> newPopulation;
+	vector<int> parents;
 	int j = 0;
 	while (j != popSize && m_Running)
 	{
 		for (int i = 0; i < popSize && m_Running; i++)
 		{
-			double p = r01(generator);
+			double p = r01(island.generator);
 
 			// select for next generation
 			if (q[j] < p && p <= q[j + 1])
 			{
 				j++;
 
-				Chromosome chromosome = population[i];
-				chromosome.id = j;
-
-				newPopulation.push_back(chromosome);
+				parents.push_back(i);
 
 				if (j == popSize) break;
 			}
 		}
 	}
 
-	return newPopulation;
+	return parents;
 }
 
-vector<Chromosome> AlgorithmOutput::SteadyStateSelection(vector<Chromosome>& population)
+vector<int> AlgorithmOutput::SteadyStateSelection(Island& island)
 {
 	// similar to the regular crossover but
 	// instead of replacing the whole population with offsprings
-	// it only replaces the worst 20% chromosomes
-
-	SetUnfitChromosomes(population);
+	// it only replaces the worst 20% chromosomes (see DoCrossover)
 
-	const int N = rows * cols;
-	uniform_int_distribution<int> i0n(0, N - 1);
-	uniform_real_distribution<double> r01(0, 1);
+	SetUnfitChromosomes(island, island.population);
 
-	vector<Chromosome> newPopulation;
-	int j = 0;
+	return ElitismSelection(island);
+}
 
-	// couple the resulted parents (p1, p2), (p3, p4) etc.
-	for (int i = 0; i < popSize - 1 && m_Running; i += 2)
-	{
-		Chromosome offspring1 = population[i];
-		Chromosome offspring2 = population[i + 1];
+vector<int> AlgorithmOutput::TournamentSelection(Island& island)
+{
+	vector<Chromosome>& population = island.population;
 
-		double p = r01(generator);
+	// randomly create a group of 2 chromosomes and select the fittest one for next generation
 
-		// parents are identical or the couple are not going to produce new offsprings
-		if (offspring1.id == offspring2.id || p > pc)
-		{
-			offspring1.id = j++;
-			offspring2.id = j++;
+	uniform_int_distribution<int> i0popSize(0, popSize - 1);
+	uniform_real_distribution<double> r01(0, 1);
 
-			newPopulation.push_back(offspring1);
-			newPopulation.push_back(offspring2);
+	vector<int> parents;
 
-			continue;
-		}
-
-		// apply crossover
-
-		// generate 2 cut-points
-		int xp1 = i0n(generator);
-		int xp2 = i0n(generator);
-
-		while (xp1 == xp2 && N > 1 && m_Running)
-		{
-			xp2 = i0n(generator);
-		}
-
-		if (xp1 > xp2) swap(xp1, xp2);
-
-		// iterate through the genes located between the cut-points
-		for (int k = xp1; k <= xp2 && m_Running; k++)
-		{
-			// exchange gene information
-			swap(offspring1.initialPattern[k], offspring2.initialPattern[k]);
-		}
-
-		offspring1.id = j++;
-		offspring2.id = j++;
-
-		// revert changes if these parents don't make up the bottom 20%
-		if (unfitChromosomes.find(population[i].id) == unfitChromosomes.end()) offspring1.initialPattern = population[i].initialPattern;
-		if (unfitChromosomes.find(population[i+1].id) == unfitChromosomes.end()) offspring2.initialPattern = population[i + 1].initialPattern;
-
-		newPopulation.push_back(offspring1);
-		newPopulation.push_back(offspring2);
-
-		if (j >= popSize) break;
-	}
-	// odd number of parents -> copy the last chromosome
-	if (popSize % 2 == 1)
-	{
-		Chromosome chromosome = population.back();
-		chromosome.id = j++;
-
-		newPopulation.push_back(chromosome);
-	}
-
-	// sort by worst to best
-	sort(newPopulation.begin(), newPopulation.end());
-
-	return newPopulation;
-}
-
-vector<Chromosome> AlgorithmOutput::TournamentSelection(vector<Chromosome>& population)
-{
-	// randomly create a group of 2 chromosomes and select the fittest one for next generation
-
-	uniform_int_distribution<int> i0popSize(0, popSize - 1);
-	uniform_real_distribution<double> r01(0, 1);
-
-	vector<Chromosome> newPopulation;
-
-	vector<int> indexes(popSize);
-	for (int i = 0; i < popSize && m_Running; i++) indexes[i] = i;
-
-	// apply this method until we have selected enough parents
-	int k = TOURNAMENT_SIZE;
-	int j = 0;
-	while (j != popSize && m_Running)
-	{
-		unordered_set<int> tournamentIndexes;
-		
-		// create a tournament with 2 distinct randomly chosen chromosomes
-		while (tournamentIndexes.size() < TOURNAMENT_SIZE && m_Running)
-		{
-			int k = i0popSize(generator);
+	// apply this method until we have selected enough parents
+	int j = 0;
+	while (j != popSize && m_Running)
+	{
+		unordered_set<int> tournamentIndexes;
+		
+		// create a tournament with 2 distinct randomly chosen chromosomes
+		while (tournamentIndexes.size() < TOURNAMENT_SIZE && m_Running)
+		{
+			int k = i0popSize(island.generator);
 
 			// make sure not to include a chromosome more than once
 			if (tournamentIndexes.find(k) == tournamentIndexes.end())
@@ -567,114 +1018,126 @@ vector<Chromosome> AlgorithmOutput::TournamentSelection(vector<Chromosome>& popu
 		}
 
 		const double r = 0.75;
-		double p = r01(generator);
+		double p = r01(island.generator);
 
 		// select the best fit
 		if (p <= r)
 		{
-			Chromosome chromosome = population[bestIndex];
-			chromosome.id = j++;
-
-			newPopulation.push_back(chromosome);
+			parents.push_back(bestIndex);
+			j++;
 		}
 		// select the worst fit
 		else
 		{
-			Chromosome chromosome = population[worstIndex];
-			chromosome.id = j++;
-
-			newPopulation.push_back(chromosome);
+			parents.push_back(worstIndex);
+			j++;
 		}
 
 		if (j == popSize) break;
 	}
 
-	return newPopulation;
+	return parents;
 }
 
-vector<Chromosome> AlgorithmOutput::ElitismSelection(vector<Chromosome>& population)
+vector<int> AlgorithmOutput::ElitismSelection(Island& island)
 {
 	// don't filter the population
 
-	return population;
+	vector<int> parents(popSize);
+	for (int i = 0; i < popSize; i++) parents[i] = i;
+
+	return parents;
 }
 
-vector<Chromosome> AlgorithmOutput::RandomSelection(vector<Chromosome>& population)
+vector<int> AlgorithmOutput::RandomSelection(Island& island)
 {
 	// iterate through the chromosomes and select parents at random
 
 	uniform_real_distribution<double> r01(0, 1);
 
-	vector<Chromosome> newPopulation;
+	vector<int> parents;
 	int j = 0;
 	while (j != popSize && m_Running)
 	{
 		for (int i = 0; i < popSize && m_Running; i++)
 		{
-			double p = r01(generator);
+			double p = r01(island.generator);
 
 			if (p > 0.5)
 			{
 				j++;
 
-				Chromosome chromosome = population[i];
-				chromosome.id = j;
-
-				newPopulation.push_back(chromosome);
+				parents.push_back(i);
 
 				if (j == popSize) break;
 			}
 		}
 	}
 
-	return newPopulation;
+	return parents;
 }
 
-vector<Chromosome> AlgorithmOutput::DoCrossover(vector<Chromosome>& population)
+vector<Chromosome> AlgorithmOutput::DoCrossover(Island& island, vector<int>& parents)
 {
-	// select chromosomes for crossover
-	// make pairs of chromosomes (called "parents")
+	vector<Chromosome>& population = island.population;
+
+	// make pairs of the selected chromosomes (called "parents")
 	// and select their offsprings to make up the new generation
 	// 
-	// return the resulted population
+	// return the resulted population, whose genes are written to island.nextGenes
+	// (which then becomes island.genes)
 
 	const int N = rows * cols;
 	uniform_int_distribution<int> i0n(0, N - 1);
 	uniform_real_distribution<double> r01(0, 1);
 
+	const bool steadyState = selectionMethod == "Steady State";
+
 	vector<Chromosome> newPopulation;
 	int j = 0;
 
+	// an offspring keeps the results of its parent until it's evaluated
+	auto addOffspring = [&](const Chromosome& parent)
+	{
+		Chromosome offspring = parent;
+		offspring.id = j++;
+
+		newPopulation.push_back(offspring);
+	};
+
 	if (selectionMethod == "Elitism")
 	{
-		SetEliteChromosomes(population);
+		SetEliteChromosomes(island, population);
 
 		// include elites first
-		for (auto i = eliteChromosomes.begin(); i != eliteChromosomes.end(); i++)
+		for (auto i = island.eliteChromosomes.begin(); i != island.eliteChromosomes.end() && j < popSize; i++)
 		{
-			Chromosome elite = population[*i];
-			elite.id = j++;
+			Chromosome& elite = population[*i];
 
-			newPopulation.push_back(elite);
+			island.nextGenes.Copy(j, island.genes, elite.id);
+			addOffspring(elite);
 		}
 	}
 
 	// couple the resulted parents (p1, p2), (p3, p4) etc.
-	for (int i = 0; i < popSize - 1 && m_Running; i += 2)
+	for (int i = 0; i + 1 < parents.size() && j < popSize && m_Running; i += 2)
 	{
-		Chromosome offspring1 = population[i];
-		Chromosome offspring2 = population[i + 1];
+		Chromosome& parent1 = population[parents[i]];
+		Chromosome& parent2 = population[parents[i + 1]];
 
-		double p = r01(generator);
+		double p = r01(island.generator);
 
-		// not going to produce new offsprings
-		if (p > pc)
+		// parents are identical or the couple are not going to produce new offsprings
+		// (there might be room for only one of them, when there are elites)
+		if ((steadyState && parent1.id == parent2.id) || p > pc || j + 1 == popSize)
 		{
-			offspring1.id = j++;
-			offspring2.id = j++;
+			island.nextGenes.Copy(j, island.genes, parent1.id);
+			addOffspring(parent1);
+
+			if (j == popSize) break;
 
-			newPopulation.push_back(offspring1);
-			newPopulation.push_back(offspring2);
+			island.nextGenes.Copy(j, island.genes, parent2.id);
+			addOffspring(parent2);
 
 			continue;
 		}
@@ -682,117 +1145,137 @@ vector<Chromosome> AlgorithmOutput::DoCrossover(vector<Chromosome>& population)
 		// apply crossover
 
 		// generate 2 cut-points
-		int xp1 = i0n(generator);
-		int xp2 = i0n(generator);
+		int xp1 = i0n(island.generator);
+		int xp2 = i0n(island.generator);
 
 		while (xp1 == xp2 && N > 1 && m_Running)
 		{
-			xp2 = i0n(generator);
+			xp2 = i0n(island.generator);
 		}
 
 		if (xp1 > xp2) swap(xp1, xp2);
 
-		// iterate through the genes located between the cut-points
-		for (int k = xp1; k <= xp2 && m_Running; k++)
-		{
-			// exchange gene information
-			swap(offspring1.initialPattern[k], offspring2.initialPattern[k]);
-		}
-
-		offspring1.id = j++;
-		offspring2.id = j++;
+		// exchange the genes located between the cut-points
+		island.nextGenes.Cross(j, j + 1, island.genes, parent1.id, parent2.id, xp1, xp2);
 
-		newPopulation.push_back(offspring1);
-		newPopulation.push_back(offspring2);
+		// SteadyState only replaces the parents that make up the bottom of the population
+		if (steadyState && island.unfitChromosomes.find(parent1.id) == island.unfitChromosomes.end()) island.nextGenes.Copy(j, island.genes, parent1.id);
+		if (steadyState && island.unfitChromosomes.find(parent2.id) == island.unfitChromosomes.end()) island.nextGenes.Copy(j + 1, island.genes, parent2.id);
 
-		if (j >= popSize) break;
+		addOffspring(parent1);
+		addOffspring(parent2);
 	}
 	// odd number of parents -> copy the last chromosome
-	if (popSize % 2 == 1)
+	if (parents.size() % 2 == 1 && j < popSize)
 	{
-		Chromosome chromosome = population.back();
-		chromosome.id = j++;
+		Chromosome& chromosome = population[parents.back()];
 
-		newPopulation.push_back(chromosome);
+		island.nextGenes.Copy(j, island.genes, chromosome.id);
+		addOffspring(chromosome);
 	}
 
-	// too many chromosomes (might happen when the selection method is "Elitism")
-	while (j-- > popSize) newPopulation.pop_back();
+	// sort by worst to best
+	if (steadyState) sort(newPopulation.begin(), newPopulation.end());
+
+	// the genes of the new population are the current ones from now on
+	swap(island.genes, island.nextGenes);
 
 	return newPopulation;
 }
 
-void AlgorithmOutput::DoMutatiton(vector<Chromosome>& population)
+void AlgorithmOutput::DoMutatiton(Island& island)
 {
+	vector<Chromosome>& population = island.population;
+
 	// select and alter genes to increase variety
 
-	if (selectionMethod == "Elitism") SetEliteChromosomes(population);
+	if (selectionMethod == "Elitism") SetEliteChromosomes(island, population);
 
 	const int N = rows * cols;
 
+	if (pm <= 0) return;
+
 	uniform_int_distribution<int> i0n(0, m_States.size() - 1);
-	uniform_real_distribution<double> r01(0, 1);
+
+	// every gene is modified with a probability of pm -> jump straight to the next one that is,
+	// instead of drawing a number for every gene
+	geometric_distribution<long long> skip(pm < 1 ? pm : 0.5);
+	auto next = [&]() { return pm < 1 ? skip(island.generator) : 0; };
 
 	for (int i = 0; i < popSize && m_Running; i++)
 	{
 		// ignore chromosome if it's one of the elites
-		if (selectionMethod == "Elitism" && eliteChromosomes.find(population[i].id) != eliteChromosomes.end()) continue;
+		if (selectionMethod == "Elitism" && island.eliteChromosomes.find(i) != island.eliteChromosomes.end()) continue;
+
+		uint8_t* genes = island.genes.Get(population[i].id);
 
 		// iterate through the chromosome's genes
-		for (int j = 0; j < N && m_Running; j++)
+		for (long long j = next(); j < N && m_Running; j += next() + 1)
 		{
-			double p = r01(generator);
+			// modify this gene
 
-			if (p <= pm)
-			{
-				// modify this gene
+			int cellType = i0n(island.generator);
 
-				int cellType = i0n(generator);
-
-				population[i].initialPattern[j] = cellType;
-			}
+			genes[j] = cellType;
 		}
 	}
 }
 
 Chromosome AlgorithmOutput::GetBestChromosome(vector<Chromosome>& population, int epoch)
 {
-	Chromosome chromosome = population[0];
+	int best = 0;
 
 	for (int i = 1; i < popSize && m_Running; i++)
 	{
-		if (population[i] > chromosome)
+		if (population[i] > population[best])
 		{
-			chromosome = population[i];
+			best = i;
 		}
 	}
 
-	return chromosome;
+	return population[best];
+}
+
+void AlgorithmOutput::SetBestChromosome(Island& island, Chromosome& chromosome)
+{
+	m_BestChromosome = chromosome;
+
+	// its slot is going to be overwritten by the next populations
+	const uint8_t* genes = island.genes.Get(chromosome.id);
+	m_BestGenes.assign(genes, genes + rows * cols);
 }
 
-void AlgorithmOutput::SetEliteChromosomes(vector<Chromosome> population)
+void AlgorithmOutput::SetEliteChromosomes(Island& island, const vector<Chromosome>& population)
 {
-	// save the IDs of the 2 elites
+	// save the indexes of the 2 elites
 
-	int k = NUMBER_OF_ELITES;
-	eliteChromosomes.clear();
+	int k = min(NUMBER_OF_ELITES, (int)population.size());
+	island.eliteChromosomes.clear();
 
-	sort(population.rbegin(), population.rend());
+	vector<int> indexes(population.size());
+	for (int i = 0; i < indexes.size(); i++) indexes[i] = i;
 
-	for (int i = 0; i < k; i++) eliteChromosomes.insert(population[i].id);
+	partial_sort(indexes.begin(), indexes.begin() + k, indexes.end(),
+		[&population](int a, int b) { return population[a].fitness > population[b].fitness; });
+
+	for (int i = 0; i < k; i++) island.eliteChromosomes.insert(indexes[i]);
 }
 
-void AlgorithmOutput::SetUnfitChromosomes(vector<Chromosome> population)
+void AlgorithmOutput::SetUnfitChromosomes(Island& island, const vector<Chromosome>& population)
 {
-	// save the IDs of the worst 10% chromosomes
+	// save the slots of the worst 10% chromosomes
 
-	int k = max(1, (int)ceil(FITNESS_CUTOFF * popSize));
+	int k = min(max(1, (int)ceil(FITNESS_CUTOFF * popSize)), (int)population.size());
 
-	unfitChromosomes.clear();
+	island.unfitChromosomes.clear();
 
-	sort(population.begin(), population.end());
+	vector<int> indexes(population.size());
+	for (int i = 0; i < indexes.size(); i++) indexes[i] = i;
+
+	partial_sort(indexes.begin(), indexes.begin() + k, indexes.end(),
+		[&population](int a, int b) { return population[a].fitness < population[b].fitness; });
 
-	for (int i = 0; i < k; i++) unfitChromosomes.insert(population[i].id);
+	for (int i = 0; i < k; i++) island.unfitChromosomes.insert(population[indexes[i]].id);
 }
 
 void AlgorithmOutput::OnStart(wxCommandEvent& evt)
@@ -810,6 +1293,16 @@ void AlgorithmOutput::OnSave(wxCommandEvent& evt)
 	Save();
 }
 
+void AlgorithmOutput::OnCheckpoint(wxCommandEvent& evt)
+{
+	RequestCheckpoint();
+}
+
+void AlgorithmOutput::OnResume(wxCommandEvent& evt)
+{
+	Resume();
+}
+
 void AlgorithmOutput::OnRender(wxCommandEvent& evt)
 {
 	m_RenderOnScreen = !m_RenderOnScreen;
@@ -819,15 +1312,45 @@ void AlgorithmOutput::Start()
 {
 	if (m_Running) return;
 
+	// checkpoints every few epochs -> they need a file to go to (a resumed run keeps using its own)
+	if (!m_ResumeFrom)
+	{
+		wxString path;
+
+		if (m_AlgorithmParameters->GetCheckpointInterval())
+		{
+			unsigned int now = time(0);
+			wxString fileName = wxString::Format("%u", now);
+
+			wxFileDialog dialogFile(this, "Save Checkpoints", "", fileName, "Checkpoint files (*.ckpt)|*.ckpt", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+
+			if (dialogFile.ShowModal() == wxID_CANCEL) return;
+
+			path = dialogFile.GetPath();
+		}
+
+		lock_guard<mutex> lock(m_MutexCheckpoint);
+		m_CheckpointPath = path;
+	}
+
+	{
+		lock_guard<mutex> lock(m_MutexCheckpoint);
+		m_CheckpointStatus = "Last Checkpoint: None";
+	}
+	UpdateTextCheckpoint();
+
 	m_Running = true;
 
 	m_Start->Disable();
 	m_Stop->Enable();
 	m_Save->Disable();
+	m_Checkpoint->Enable();
+	m_Resume->Disable();
 
 	m_BestChromosome.id = -1;
 
-	m_TimeElapsed = -1;
+	// a resumed run goes on counting from where it was left
+	m_TimeElapsed = m_ResumeFrom ? m_ResumeFrom->timeElapsed - 1 : -1;
 	m_Timer->Start(1000);
 
 	thread t(&AlgorithmOutput::RunAlgorithm, this);
@@ -842,6 +1365,69 @@ void AlgorithmOutput::Stop()
 
 	m_Start->Enable();
 	m_Stop->Disable();
+	m_Checkpoint->Disable();
+}
+
+void AlgorithmOutput::RequestCheckpoint()
+{
+	if (!m_Running) return;
+
+	wxString path;
+	{
+		lock_guard<mutex> lock(m_MutexCheckpoint);
+		path = m_CheckpointPath;
+	}
+
+	// the first one of this run
+	if (path.empty())
+	{
+		unsigned int now = time(0);
+		wxString fileName = wxString::Format("%u", now);
+
+		wxFileDialog dialogFile(this, "Save Checkpoint", "", fileName, "Checkpoint files (*.ckpt)|*.ckpt", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+
+		if (dialogFile.ShowModal() == wxID_CANCEL) return;
+
+		path = dialogFile.GetPath();
+	}
+
+	// every island adds itself to it at the end of its current epoch
+	lock_guard<mutex> lock(m_MutexCheckpoint);
+	m_CheckpointPath = path;
+	m_CheckpointRequested.assign(m_CheckpointRequested.size(), true);
+}
+
+void AlgorithmOutput::Resume()
+{
+	if (m_Running) return;
+
+	wxFileDialog dialogFile(this, "Resume Checkpoint", "", "", "Checkpoint files (*.ckpt)|*.ckpt", wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+
+	if (dialogFile.ShowModal() == wxID_CANCEL) return;
+
+	unique_ptr<Checkpoint> checkpoint = make_unique<Checkpoint>();
+	string error = checkpoint->Read(dialogFile.GetPath().ToStdString());
+
+	if (error.size())
+	{
+		wxRichMessageDialog dialog(
+			this, "The checkpoint can't be read.", "Error",
+			wxOK | wxICON_ERROR
+		);
+		dialog.ShowDetailedText(error);
+		dialog.ShowModal();
+
+		return;
+	}
+
+	// the next checkpoints of the run go to the same file
+	{
+		lock_guard<mutex> lock(m_MutexCheckpoint);
+		m_CheckpointPath = dialogFile.GetPath();
+	}
+
+	m_ResumeFrom = move(checkpoint);
+	Start();
 }
 
 void AlgorithmOutput::Save()
@@ -857,19 +1443,24 @@ void AlgorithmOutput::Save()
 
 	out << "[ALGORITHM SETTINGS]\n";
 	out << wxString::Format(
-		"%s\n%s\n\n%s\n\nSelection Method: %s\nPopulation Size: %i\nProbability of Mutation: %f\nProbability of Crossover: %f\n\n%s",
+		"%s\n%s\n\n%s\n\nSelection Method: %s\nPopulation Size: %i\nProbability of Mutation: %f\nProbability of Crossover: %f\n\n%s\n%s",
 		m_TextElapsed->GetLabel(), m_TextEpoch->GetLabel(),
 		wxString::Format(
-			"Reached generation: %i\nReached avg. population: %i\nInitial size: %i\nFitness: %f",
-			m_BestChromosome.nOfGenerations, m_BestChromosome.avgPopulation, m_BestChromosome.initialSize, m_BestChromosome.fitness
+			"Reached generation: %i\nReached avg. population: %i\nInitial size: %i\nFitness: %f\nPeriod: %i\nTransient: %i",
+			m_BestChromosome.nOfGenerations, m_BestChromosome.avgPopulation, m_BestChromosome.initialSize, m_BestChromosome.fitness,
+			m_BestChromosome.period, m_BestChromosome.transient
+		),
+		selectionMethod, popSize * nIslands, pm, pc,
+		wxString::Format(
+			"Islands: %i\nMigration Interval: %i\nMigrants: %i\nMigration Topology: %s\n",
+			nIslands, migrationInterval, nMigrants, migrationTopology
 		),
-		selectionMethod, popSize, pm, pc,
 		wxString::Format(
 			"Generation Multiplier: %f\nPopullation Multiplier: %f\nInitial Size Multiplier: %f\n\n%s",
 			generationMultiplier, populationMultiplier, initialSizeMultiplier,
 			wxString::Format(
-				"Epochs Target: %i\nGeneration Target: %i\nPopulation Target: %i\n",
-				epochsTarget, generationTarget, populationTarget
+				"Epochs Target: %i\nGeneration Target: %i\nPopulation Target: %i\nPeriod Limit: %i\n",
+				epochsTarget, generationTarget, populationTarget, periodLimit
 			)
 		)
 	) << "\n";
@@ -885,7 +1476,10 @@ void AlgorithmOutput::Save()
 	out << '\n';
 
 	out << "[SIZE]\n";
-	out << rows << ' ' << cols << '\n';
+	out << rows << ' ' << cols;
+	if (topology != TOPOLOGY_BOUNDED) out << ' ' << TOPOLOGY_NAMES[topology];
+	if (topology == TOPOLOGY_BORDER) out << ' ' << m_States[border];
+	out << '\n';
 
 	out << "[CELLS]\n";
 	for (int i = 0; i < rows; i++)
@@ -894,11 +1488,11 @@ void AlgorithmOutput::Save()
 		{
 			int k = i * cols + j;
 
-			if (m_BestChromosome.initialPattern[k])
+			if (m_BestGenes[k])
 			{
 				int x = j - cols / 2;
 				int y = i - rows / 2;
-				string state = m_States[m_BestChromosome.initialPattern[k]];
+				string state = m_States[m_BestGenes[k]];
 
 				out << x << ' ' << y << ' ' << state << ';' << '\n';
 			}
@@ -911,6 +1505,17 @@ void AlgorithmOutput::UpdateTextEpoch(int epoch)
 	m_TextEpoch->SetLabel(wxString::Format("Epoch: %i", epoch));
 }
 
+void AlgorithmOutput::UpdateTextCheckpoint()
+{
+	wxString status;
+	{
+		lock_guard<mutex> lock(m_MutexCheckpoint);
+		status = m_CheckpointStatus;
+	}
+
+	if (status.size()) m_TextCheckpoint->SetLabel(status);
+}
+
 void AlgorithmOutput::UpdateTextElapsed(int elapsed)
 {
 	int seconds = elapsed % 60;
@@ -924,12 +1529,22 @@ void AlgorithmOutput::UpdateTextElapsed(int elapsed)
 	m_TextElapsed->SetLabel(wxString::Format("Time Elapsed: %s:%s:%s", textHours, textMinutes, textSeconds));
 }
 
+void AlgorithmOutput::UpdateTextCache()
+{
+	long long hits = m_FitnessCache.GetHits();
+	long long lookups = m_FitnessCache.GetLookups();
+	double rate = lookups ? 100.0 * hits / lookups : 0.0;
+
+	m_TextCache->SetLabel(wxString::Format("Cache Hits: %.1f%% (%lld of %lld)", rate, hits, lookups));
+}
+
 void AlgorithmOutput::UpdateTextLast(Chromosome& chromosome)
 {
 	m_TextLastFitness->SetLabel(to_string(chromosome.fitness));
 	m_TextLastNofGeneration->SetLabel(to_string(chromosome.nOfGenerations));
 	m_TextLastAvgPopulation->SetLabel(to_string(chromosome.avgPopulation));
 	m_TextLastInitialSize->SetLabel(to_string(chromosome.initialSize));
+	m_TextLastPeriod->SetLabel(to_string(chromosome.period));
 }
 
 void AlgorithmOutput::UpdateTextBest(Chromosome& chromosome)
@@ -938,542 +1553,31 @@ void AlgorithmOutput::UpdateTextBest(Chromosome& chromosome)
 	m_TextBestNofGeneration->SetLabel(to_string(chromosome.nOfGenerations));
 	m_TextBestAvgPopulation->SetLabel(to_string(chromosome.avgPopulation));
 	m_TextBestInitialSize->SetLabel(to_string(chromosome.initialSize));
+	m_TextBestPeriod->SetLabel(to_string(chromosome.period));
 }
 
-pair<vector<pair<string, pair<int, int>>>, string> AlgorithmOutput::ParseAllRules(
-	unordered_map<int, string>& cells, unordered_map<string, unordered_set<int>>& statePositions,
-	unordered_map<string, string>& states, vector<pair<string, Transition>>& rules, unordered_set<string>& neighbors
-)
-{
-	vector<pair<string, pair<int, int>>> changes;
-	unordered_set<int> visited;
-
-	for (int i = 0; i < rules.size(); i++)
-	{
-		if (!m_Running) break;
-
-		pair<vector<pair<int, int>>, string> result = ParseRule(rules[i], cells, statePositions, states, neighbors, visited);
-
-		// error
-		if (result.second.size())
-		{
-			// mark the problematic rule index
-			result.second += " at rule number " + to_string(i);
-
-			return { {}, result.second };
-		}
-		// concatenate changes
-		else
-		{
-			string newstate = rules[i].first + "*" + rules[i].second.state + "*";
-
-			for (auto& change : result.first)
-			{
-				if (!m_Running) break;
-
-				changes.push_back({ newstate , change });
-			}
-		}
-	}
-
-	return { changes,"" };
-}
-
-pair<vector<pair<int, int>>, string> AlgorithmOutput::ParseRule(pair<string, Transition>& rule,
-	unordered_map<int, string>& cells, unordered_map<string, unordered_set<int>>& statePositions,
-	unordered_map<string, string>& states, unordered_set<string>& neighbors,
-	unordered_set<int>& visited)
+void AlgorithmOutput::UpdateGeneration(Evaluator& evaluator)
 {
-	vector<pair<int, int>> applied;
-
-	// if state is "FREE", apply rule to all "FREE" cells
-	if (rule.first == "FREE")
-	{
-		// iterate through all cells
-		if (rule.second.all || rule.second.condition.empty())
-		{
-			const int N = rows * cols;
-
-			for (int i = 0; i < N && m_Running; i++)
-			{
-				int x = i % rows;
-				int y = i / cols;
-
-				if (GetState(x, y, cells) == "FREE" && visited.find(i) == visited.end() && ApplyOnCell(x, y, rule.second, cells, neighbors))
-				{
-					applied.push_back({ x,y });
-					visited.insert(i);
-				}
-			}
-		}
-		// decide if it's faster to iterate through all cells
-		// or through the condition states' neighbors
-		else
-		{
-			int n1 = rows * cols - cells.size();
-			int n2 = 0;
-			for (auto& state : rule.second.states)
-			{
-				if (!m_Running) break;
-
-				if (statePositions.find(state) == statePositions.end()) continue;
-				n2 += statePositions[state].size();
-			}
-
-			// faster to iterate through all cells
-			if (n1 <= n2 || rule.second.condition.empty())
-			{
-				const int N = rows * cols;
-
-				for (int i = 0; i < N && m_Running; i++)
-				{
-					int x = i % rows;
-					int y = i / cols;
-
-					if (GetState(x, y, cells) == "FREE" && visited.find(i) == visited.end() && ApplyOnCell(x, y, rule.second, cells, neighbors))
-					{
-						applied.push_back({ x,y });
-						visited.insert(i);
-					}
-				}
-			}
-			// faster to iterate through the condition states' neighbors
-			else
-			{
-				for (auto& state : rule.second.states)
-				{
-					if (!m_Running) break;
-
-					if (state == "FREE")
-					{
-						const int N = rows * cols;
-
-						for (int i = 0; i < N && m_Running; i++)
-						{
-							int x = i % rows;
-							int y = i / cols;
-							int k = i;
-
-							if (visited.find(k) == visited.end() && GetState(x, y, cells) == "FREE" && ApplyOnCell(x, y, rule.second, cells, neighbors))
-							{
-								applied.push_back({ x,y });
-								visited.insert(k);
-							}
-						}
-					}
-					// cells of this type are placed on grid
-					else if (statePositions.find(state) != statePositions.end())
-					{
-						int dx[8] = { 0,1,1,1,0,-1,-1,-1 };
-						int dy[8] = { -1,-1,0,1,1,1,0,-1 };
-
-						for (auto i = statePositions.at(state).begin(); i != statePositions.at(state).end(); i++)
-						{
-							if (!m_Running)break;
-
-							int k = *i;
-							int x = k % cols;
-							int y = k / cols;
-
-							for (int d = 0; d < 8 && m_Running; d++)
-							{
-								int nx = x + dx[d];
-								int ny = y + dy[d];
-								int k = ny * cols + nx;
-
-								if (visited.find(k) == visited.end() && InBounds(nx, ny) && GetState(nx, ny, cells) == rule.first && ApplyOnCell(nx, ny, rule.second, cells, neighbors))
-								{
-									applied.push_back({ nx,ny });
-									visited.insert(k);
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-	}
-	// else, get all cells of that type
-	else
-	{
-		if (statePositions.find(rule.first) == statePositions.end()) return { {},"" };
-
-		// iterate through all cells
-		if (rule.second.all || rule.second.condition.empty())
-		{
-			string state = rule.first;
-			for (auto i = statePositions.at(state).begin(); i != statePositions.at(state).end(); i++)
-			{
-				if (!m_Running) break;
+	// overwrite the cells with their new states
+	for (auto& change : evaluator.changes) evaluator.cells.Set(change.cell, change.to);
 
-				int k = *i;
-				int x = k % cols;
-				int y = k / cols;
-
-				if (visited.find(k) == visited.end() && ApplyOnCell(x, y, rule.second, cells, neighbors))
-				{
-					applied.push_back({ x,y });
-					visited.insert(k);
-				}
-			}
-		}
-		// decide if it's faster to iterate through all cells
-		// or through the condition states' neighbors
-		else
-		{
-			int n1 = statePositions[rule.first].size();
-			int n2 = 0;
-			for (auto& state : rule.second.states)
-			{
-				if (!m_Running) break;
-
-				if (statePositions.find(state) == statePositions.end()) continue;
-				n2 += statePositions[state].size();
-			}
-
-			// faster to iterate through all cells
-			if (n1 <= n2 || rule.second.condition.empty())
-			{
-				string state = rule.first;
-				for (auto i = statePositions.at(state).begin(); i != statePositions.at(state).end(); i++)
-				{
-					if (!m_Running) break;
-
-					int k = *i;
-					int x = k % cols;
-					int y = k / cols;
-
-					if (visited.find(k) == visited.end() && ApplyOnCell(x, y, rule.second, cells, neighbors))
-					{
-						applied.push_back({ x,y });
-						visited.insert(k);
-					}
-				}
-			}
-			// faster to iterate through the condition states' neighbors
-			else
-			{
-				for (auto& state : rule.second.states)
-				{
-					if (!m_Running) break;
-
-					if (state == "FREE")
-					{
-						string state = rule.first;
-						for (auto i = statePositions.at(state).begin(); i != statePositions.at(state).end(); i++)
-						{
-							int k = *i;
-							int x = k % cols;
-							int y = k / cols;
-
-							if (visited.find(k) == visited.end() && ApplyOnCell(x, y, rule.second, cells, neighbors))
-							{
-								applied.push_back({ x,y });
-								visited.insert(k);
-							}
-						}
-					}
-					// cells of this type are placed on grid
-					else if (statePositions.find(state) != statePositions.end())
-					{
-						int dx[8] = { 0,1,1,1,0,-1,-1,-1 };
-						int dy[8] = { -1,-1,0,1,1,1,0,-1 };
-
-						for (auto i = statePositions.at(state).begin(); i != statePositions.at(state).end(); i++)
-						{
-							if (!m_Running) break;
-
-							int k = *i;
-							int x = k % cols;
-							int y = k / cols;
-
-							for (int d = 0; d < 8 && m_Running; d++)
-							{
-								int nx = x + dx[d];
-								int ny = y + dy[d];
-								int k = ny * cols + nx;
-
-								if (visited.find(k) == visited.end() && InBounds(nx, ny) && GetState(nx, ny, cells) == rule.first && ApplyOnCell(nx, ny, rule.second, cells, neighbors))
-								{
-									applied.push_back({ nx,ny });
-									visited.insert(k);
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-	}
-
-	return { applied, "" };
-}
-
-string AlgorithmOutput::CheckValidAutomaton(unordered_map<string, string>& states, vector<pair<string, Transition>>& rules, unordered_set<string>& neighbors)
-{
-	string errors = "";
-
-	for (int i = 0; i < rules.size(); i++)
-	{
-		// check if rule might contain invalid states
-		if (states.find(rules[i].first) == states.end())
-			errors += (wxString::Format("<INVALID FIRST STATE> at rule number %i\n", i).ToStdString());
-
-		if (states.find(rules[i].second.state) == states.end())
-			errors += (wxString::Format("<INVALID SECOND STATE at rule number %i\n", i).ToStdString());
-
-		for (auto& state : rules[i].second.states)
-		{
-			if (states.find(state) == states.end())
-				errors += (wxString::Format("<INVALID CONDITION STATE at rule number %i\n", i).ToStdString());
-		}
-		// check for neighborhood as well
-		for (auto& direction : rules[i].second.directions)
-		{
-			if (neighbors.find(direction) == neighbors.end())
-				errors += (wxString::Format("<INVALID NEIGHBORHOOD at rule number %i\n", i).ToStdString());
-		}
-	}
-
-	return errors;
-}
-
-string AlgorithmOutput::GetState(int x, int y, unordered_map<int, string>& cells)
-{
-	int k = y * cols + x;
-
-	if (cells.find(k) == cells.end()) return "FREE";
-
-	return cells[k];
-}
-
-bool AlgorithmOutput::InBounds(int x, int y)
-{
-	return (x >= 0 && x < cols&& y >= 0 && y < rows);
-}
-
-unordered_map<string, string> AlgorithmOutput::GetNeighborhood(int x, int y, unordered_map<int, string>& cells)
-{
-	unordered_map<string, string> neighborhood;
-
-	unordered_map<string, pair<int, int>> dxy(
-		{
-			{ "NW",{-1,-1} }, { "N",{0,-1} }, { "NE",{1,-1} },
-			{ "W",{-1,0} }, { "C",{0,0} }, { "E",{1,0} },
-			{ "SW",{-1,1} }, { "S",{0,1} }, { "SE",{1,1} },
-		}
-	);
-
-	// iterate through neighbors and mark the state they have
-	for (auto& neighbor : m_Neighbors)
-	{
-		pair<int, int> d = dxy[neighbor];
-
-		int nx = x + d.first;
-		int ny = y + d.second;
-
-		if (InBounds(nx, ny)) neighborhood.insert({ neighbor,GetState(nx,ny, cells) });
-	}
-
-	return neighborhood;
-}
-
-bool AlgorithmOutput::ApplyOnCell(int x, int y, Transition& rule, unordered_map<int, string>& cells, unordered_set<string>& neighbors)
-{
-	unordered_map<string, string> neighborhood = GetNeighborhood(x, y, cells);
-
-	bool ruleValid = true;
-	// iterate through the chain of "OR" rules
-	for (auto& rulesOr : rule.orRules)
-	{
-		if (!m_Running) break;
-
-		ruleValid = true;
-
-		// iterate through the chain of "AND" rules
-		for (auto& rulesAnd : rulesOr)
-		{
-			if (!m_Running) break;
-
-			vector<string> ruleNeighborhood = rulesAnd.first;
-
-			bool conditionValid = true;
-			// iterate through the chain of "OR" conditions
-			for (auto& conditionsOr : rulesAnd.second)
-			{
-				if (!m_Running) break;
-
-				conditionValid = true;
-
-				// iterate through the chain of "AND" conditions
-				for (auto& conditionsAnd : conditionsOr)
-				{
-					if (!m_Running) break;
-
-					string conditionState = conditionsAnd.second;
-
-					int occurences = 0;
-					if (ruleNeighborhood[0] == "ALL")
-					{
-						for (auto& neighbor : neighborhood)
-						{
-							if (!m_Running) break;
-
-							if (neighbor.second == conditionState) occurences++;
-						}
-					}
-					else for (auto& neighbor : ruleNeighborhood)
-					{
-						if (!m_Running) break;
-
-						if (neighbors.find(neighbor) != neighbors.end())
-						{
-							if (neighborhood[neighbor] == conditionState) occurences++;
-						}
-					}
-
-					int conditionNumber = conditionsAnd.first.first;
-					int conditionType = conditionsAnd.first.second;
-
-					switch (conditionType)
-					{
-					case TYPE_EQUAL:
-						if (occurences != conditionNumber) conditionValid = false;
-						break;
-					case TYPE_LESS:
-						if (occurences >= conditionNumber) conditionValid = false;
-						break;
-					case TYPE_MORE:
-						if (occurences <= conditionNumber) conditionValid = false;
-						break;
-					default:
-						break;
-					}
-				}
-
-				if (conditionValid) break;
-			}
-
-			if (!conditionValid)
-			{
-				ruleValid = false;
-				break;
-			}
-		}
-
-		if (ruleValid) break;
-	}
-
-	return ruleValid;
-}
-
-void AlgorithmOutput::UpdateGeneration(vector<pair<string, pair<int, int>>>& changes, vector<int>& pattern,
-	unordered_map<int, string>& cells, unordered_map<string, unordered_set<int>>& statePositions)
-{
-	for (auto& change : changes)
-	{
-		if (!m_Running) break;
-
-		string state = change.first;
-
-		state.pop_back();
-
-		string prevState = "";
-		string currState = "";
-		bool separator = false;
-		// regain information of previous and current state
-		for (int i = 0; i < state.size() && m_Running; i++)
-		{
-			if (state[i] == '*')
-			{
-				separator = true;
-				continue;
-			}
-
-			if (!separator) prevState.push_back(state[i]);
-			else currState.push_back(state[i]);
-		}
-
-		// insert positions into the current state map and remove them from the previous one
-		auto position = change.second;
-		int x = position.first;
-		int y = position.second;
-		int k = y * cols + x;
-
-		if (prevState == "FREE")
-		{
-			if (currState != "FREE")
-			{
-				cells[k] = currState;
-				statePositions[currState].insert(k);
-				pattern[k] = find(m_States.begin(), m_States.end(), currState) - m_States.begin();
-			}
-		}
-		else
-		{
-			if (currState == "FREE")
-			{
-				cells.erase(k);
-				statePositions[prevState].erase(k);
-				pattern[k] = 0;
-
-				// there are no more cells of this state anymore -> remove it from our map
-				if (statePositions[prevState].size() == 0)
-				{
-					statePositions.erase(prevState);
-				}
-			}
-			else if (cells[k] != currState)
-			{
-				cells.erase(k);
-				statePositions[prevState].erase(k);
-
-				// there are no more cells of this state anymore -> remove it from our map
-				if (statePositions[prevState].size() == 0)
-				{
-					statePositions.erase(prevState);
-				}
-
-				cells[k] = currState;
-				statePositions[currState].insert(k);
-				pattern[k] = find(m_States.begin(), m_States.end(), currState) - m_States.begin();
-			}
-		}
-	}
-}
-
-void AlgorithmOutput::UpdateChromosomesMaps(vector<Chromosome>& population)
-{
-	for (int i = 0; i < popSize && m_Running; i++)
-	{
-		int initialSize = 0;
-		unordered_map<int, string> cells;
-		unordered_map<string, unordered_set<int>> statePositions;
-
-		for (int j = 0; j < rows * cols && m_Running; j++)
-		{
-			int cellType = population[i].initialPattern[j];
-
-			if (cellType)
-			{
-				initialSize++;
-				cells[j] = m_States[cellType];
-				statePositions[m_States[cellType]].insert(j);
-			}
-		}
-
-		population[i].initialSize = initialSize;
-		population[i].cells = cells;
-		population[i].statePositions = statePositions;
-	}
+	// there's no undo history here -> keep the back buffer in sync
+	evaluator.cells.Commit();
+	evaluator.engine.Commit(evaluator.changes, evaluator.cells);
 }
 
 void AlgorithmOutput::EndAlgorithm(bool save)
 {
 	m_Timer->Stop();
 
+	// the last checkpoint is complete once the run is over
+	StopCheckpointWriter();
+	UpdateTextCheckpoint();
+
 	m_Start->Enable();
 	m_Stop->Disable();
+	m_Checkpoint->Disable();
+	m_Resume->Enable();
 
 	if (save && m_BestChromosome.id != -1) m_Save->Enable();
 
@@ -1484,7 +1588,8 @@ void AlgorithmOutput::UpdateTimer(wxTimerEvent& evt)
 {
 	if (!m_Running) m_Timer->Stop();
 
-	m_TimeElapsed++;
+	int elapsed = ++m_TimeElapsed;
 
-	UpdateTextElapsed(m_TimeElapsed);
+	UpdateTextElapsed(elapsed);
+	UpdateTextCheckpoint();
 }
@@ -7,8 +7,21 @@
 #include "InputNeighbors.h"
 #include "AlgorithmParameters.h"
 #include "Chromosome.h"
+#include "Checkpoint.h"
+#include "GenePool.h"
+#include "FitnessCache.h"
+#include "Mailbox.h"
+#include "RuleSet.h"
+#include "RuleEngine.h"
+#include "ThreadPool.h"
 
 #include <random>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 class AlgorithmOutput : public wxPanel
 {
@@ -31,8 +44,12 @@ private:
 	wxButton* m_Start = nullptr;
 	wxButton* m_Stop = nullptr;
 	wxButton* m_Save = nullptr;
+	wxButton* m_Checkpoint = nullptr;
+	wxButton* m_Resume = nullptr;
 	wxStaticText* m_TextEpoch = nullptr;
 	wxStaticText* m_TextElapsed = nullptr;
+	wxStaticText* m_TextCache = nullptr;
+	wxStaticText* m_TextCheckpoint = nullptr;
 
 	wxStaticText* m_TextLastAvgPopulation = nullptr;
 	wxStaticText* m_TextBestAvgPopulation = nullptr;
@@ -43,6 +60,9 @@ private:
 	wxStaticText* m_TextLastInitialSize = nullptr;
 	wxStaticText* m_TextBestInitialSize = nullptr;
 
+	wxStaticText* m_TextLastPeriod = nullptr;
+	wxStaticText* m_TextBestPeriod = nullptr;
+
 	wxStaticText* m_TextLastFitness = nullptr;
 	wxStaticText* m_TextBestFitness = nullptr;
 
@@ -52,11 +72,60 @@ private:
 	vector<string> m_Rules;
 	vector<string> m_Neighbors;
 
+	// ids follow the order of m_States, so they can be stored directly in the patterns
+	StateRegistry m_Registry;
+	shared_ptr<const RuleSet> m_RuleSet;
+
+	// what a thread needs to play out the chromosomes it takes (the cells are built from the genes of
+	// one chromosome at a time), kept between epochs so the memory is reused
+	struct Evaluator
+	{
+		Universe cells;
+		RuleEngine engine;
+		vector<Change> changes;
+
+		// hashes of the last periodLimit generations (oldest first) and the generation each of them was seen at
+		deque<unsigned long long> history;
+		unordered_map<unsigned long long, int> historyGenerations;
+	};
+
+	// a population evolving on its own, with its own random numbers; the islands
+	// run on their own threads and only meet through their mailboxes
+	struct Island
+	{
+		default_random_engine generator;
+		vector<Chromosome> population;
+
+		// genes of the current population and of the one made out of it, swapped every epoch
+		GenePool genes;
+		GenePool nextGenes;
+
+		unordered_set<int> eliteChromosomes;
+		unordered_set<int> unfitChromosomes;
+
+		// the chromosomes of the population are evaluated at the same time, one evaluator for every thread
+		vector<Evaluator> evaluators;
+
+		// the best chromosomes of the other islands
+		Mailbox mailbox;
+
+		// the last epoch it got to and if its population was evaluated by then; it isn't intact
+		// if it was stopped while making a population, so it can't be picked up from there
+		int epoch = 0;
+		bool evaluated = false;
+		bool intact = true;
+	};
+
+	vector<Island> m_Islands;
+	ThreadPool m_ThreadPool;
+
 	bool m_RenderOnScreen;
-	bool m_Running;
+	atomic<bool> m_Running;
 
 	int m_Epoch;
-	int m_TimeElapsed;
+
+	// counted by the timer, read by the islands when they write a checkpoint
+	atomic<int> m_TimeElapsed;
 
 	double m_LastAvgPopulation;
 	double m_LastNofGeneration;
@@ -71,10 +140,13 @@ private:
 	const int NUMBER_OF_ELITES = 2;
 	const int TOURNAMENT_SIZE = 2;
 	const double FITNESS_CUTOFF = 0.1;
+	const int FITNESS_CACHE_SIZE = 1 << 16;
 
 	int popSize;
 	int rows;
 	int cols;
+	int topology;
+	StateId border;
 	double pc;
 	double pm;
 	double generationMultiplier;
@@ -83,64 +155,102 @@ private:
 	int epochsTarget;
 	int generationTarget;
 	int populationTarget;
-	default_random_engine generator;
+	int periodLimit;
+	int nIslands;
+	int migrationInterval;
+	int nMigrants;
+	int checkpointInterval;
+	wxString migrationTopology;
 	wxString selectionMethod;
+
+	// of all the islands; copied only when a better chromosome is found, its slot is reused by the next epochs
 	Chromosome m_BestChromosome;
+	vector<uint8_t> m_BestGenes;
+
+	// the islands report the end of their epochs one at a time
+	mutex m_MutexReport;
+	vector<int> m_IslandEpochs;
+
+	// results of the patterns already played out during this run
+	FitnessCache m_FitnessCache;
+
+	// the checkpoint being put together, an island at a time (under m_MutexReport), and the islands already in it;
+	// it's written by its own thread, one file at a time
+	Checkpoint m_NextCheckpoint;
+	vector<char> m_CheckpointTaken;
+	thread m_CheckpointWriter;
+	condition_variable m_CheckpointWake;
 
-	unordered_set<int> eliteChromosomes;
-	unordered_set<int> unfitChromosomes;
+	// shared with the UI thread, which never waits for m_MutexReport: where the checkpoints go,
+	// the islands asked for one and how the last one went
+	mutex m_MutexCheckpoint;
+	wxString m_CheckpointPath;
+	vector<char> m_CheckpointRequested;
+	wxString m_CheckpointStatus;
+
+	// the next file for the writer; a newer checkpoint replaces it if the last one is still being written
+	shared_ptr<Checkpoint> m_CheckpointQueued;
+	string m_CheckpointQueuedPath;
+	bool m_CheckpointWriterStop = false;
+
+	// the run picked up by the next start, if any
+	unique_ptr<Checkpoint> m_ResumeFrom;
 
 	void BuildInterface();
 	void RunAlgorithm();
 	void GetParameters();
 
-	vector<Chromosome> InitializePopulation();
-	void EvaluatePopulation(vector<Chromosome>& population, unordered_map<string, string>& states,
-		vector<pair<string, Transition>>& rules, unordered_set<string>& neighbors);
-	vector<Chromosome> SelectPopulation(vector<Chromosome>& population);
-	vector<Chromosome> RouletteWheelSelection(vector<Chromosome>& population);
-	vector<Chromosome> RankSelection(vector<Chromosome>& population);
-	vector<Chromosome> SteadyStateSelection(vector<Chromosome>& population);
-	vector<Chromosome> TournamentSelection(vector<Chromosome>& population);
-	vector<Chromosome> ElitismSelection(vector<Chromosome>& population);
-	vector<Chromosome> RandomSelection(vector<Chromosome>& population);
-	vector<Chromosome> DoCrossover(vector<Chromosome>& population);
-	void DoMutatiton(vector<Chromosome>& population);
+	void RunIsland(int i);
+	void Migrate(int i, int epoch);
+	void ReportEpoch(int i, int epoch);
+
+	string ResumeCheckpoint(const Checkpoint& checkpoint);
+	void CaptureIsland(int i);
+	void CheckpointIsland(int i);
+	void WriteCheckpoint(const wxString& path);
+	void WriteCheckpoints();
+	void StopCheckpointWriter();
+
+	vector<Chromosome> InitializePopulation(Island& island);
+	void EvaluatePopulation(Island& island);
+	void EvaluateChromosomes(int e, Island& island, atomic<int>& next);
+	void EvaluateChromosome(Chromosome& chromosome, const GenePool& pool, Evaluator& evaluator);
+	vector<int> SelectPopulation(Island& island);
+	vector<int> RouletteWheelSelection(Island& island);
+	vector<int> RankSelection(Island& island);
+	vector<int> SteadyStateSelection(Island& island);
+	vector<int> TournamentSelection(Island& island);
+	vector<int> ElitismSelection(Island& island);
+	vector<int> RandomSelection(Island& island);
+	vector<Chromosome> DoCrossover(Island& island, vector<int>& parents);
+	void DoMutatiton(Island& island);
 	Chromosome GetBestChromosome(vector<Chromosome>& population, int epoch);
-	void SetEliteChromosomes(vector<Chromosome> population);
-	void SetUnfitChromosomes(vector<Chromosome> population);
+	void SetBestChromosome(Island& island, Chromosome& chromosome);
+	void SetEliteChromosomes(Island& island, const vector<Chromosome>& population);
+	void SetUnfitChromosomes(Island& island, const vector<Chromosome>& population);
 
 	void OnStart(wxCommandEvent& evt);
 	void OnStop(wxCommandEvent& evt);
 	void OnSave(wxCommandEvent& evt);
+	void OnCheckpoint(wxCommandEvent& evt);
+	void OnResume(wxCommandEvent& evt);
 	void OnRender(wxCommandEvent& evt);
 
 	void Start();
 	void Stop();
 	void Save();
+	void RequestCheckpoint();
+	void Resume();
 
 	void UpdateTextEpoch(int epoch);
 	void UpdateTextElapsed(int elapsed);
+	void UpdateTextCache();
+	void UpdateTextCheckpoint();
 	void UpdateTextLast(Chromosome& chromosome);
 	void UpdateTextBest(Chromosome& chromosome);
 
-	pair<vector<pair<string, pair<int, int>>>, string> ParseAllRules(
-		unordered_map<int, string>& cells, unordered_map<string, unordered_set<int>>& statePositions,
-		unordered_map<string, string>& states, vector<pair<string, Transition>>& rules, unordered_set<string>& neighbors);
-	pair<vector<pair<int, int>>, string> ParseRule(pair<string, Transition>& rule,
-		unordered_map<int, string>& cells, unordered_map<string, unordered_set<int>>& statePositions,
-		unordered_map<string, string>& states, unordered_set<string>& neighbors,
-		unordered_set<int>& visited);
-	string CheckValidAutomaton(unordered_map<string,string>& states, vector<pair<string, Transition>>& rules, unordered_set<string>& neighbors);
-
-	string GetState(int x, int y, unordered_map<int, string>& cells);
-	bool InBounds(int x, int y);
-	unordered_map<string, string> GetNeighborhood(int x, int y, unordered_map<int, string>& cells);
-	bool ApplyOnCell(int x, int y, Transition& rule, unordered_map<int, string>& cells, unordered_set<string>& neighbors);
-	void UpdateGeneration(vector<pair<string, pair<int, int>>>& changes, vector<int>& pattern,
-		unordered_map<int, string>& cells, unordered_map<string, unordered_set<int>>& statePositions);
-
-	void UpdateChromosomesMaps(vector<Chromosome>& population);
+	void UpdateGeneration(Evaluator& evaluator);
+
 	void EndAlgorithm(bool save = true);
 
 	wxDECLARE_EVENT_TABLE();
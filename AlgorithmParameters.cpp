@@ -39,6 +39,11 @@ int AlgorithmParameters::GetEpochsTarget()
 	return m_EpochsTarget->GetValue();
 }
 
+int AlgorithmParameters::GetPeriodLimit()
+{
+	return m_PeriodLimit->GetValue();
+}
+
 double AlgorithmParameters::GetGenerationMultiplier()
 {
 	return m_GenerationMultiplier->GetValue();
@@ -59,6 +64,31 @@ wxString AlgorithmParameters::GetSelectionMethod()
 	return m_SelectionMethod->GetValue();
 }
 
+int AlgorithmParameters::GetIslands()
+{
+	return m_Islands->GetValue();
+}
+
+int AlgorithmParameters::GetMigrationInterval()
+{
+	return m_MigrationInterval->GetValue();
+}
+
+int AlgorithmParameters::GetMigrants()
+{
+	return m_Migrants->GetValue();
+}
+
+wxString AlgorithmParameters::GetMigrationTopology()
+{
+	return m_MigrationTopology->GetValue();
+}
+
+int AlgorithmParameters::GetCheckpointInterval()
+{
+	return m_CheckpointInterval->GetValue();
+}
+
 void AlgorithmParameters::BuildInterface()
 {
 	// POP SIZE, PM, PC
@@ -149,13 +179,21 @@ void AlgorithmParameters::BuildInterface()
 	m_EpochsTarget->SetRange(0, 10000);
 	m_EpochsTarget->SetValue(10);
 
-	wxGridSizer* sizerTargets = new wxGridSizer(2, 3, 0, 6);
+	wxStaticText* textPeriodLimit = new wxStaticText(this, wxID_ANY, "Period Limit");
+	textPeriodLimit->SetToolTip("0 - 1,000");
+	m_PeriodLimit = new wxSpinCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxSP_WRAP | wxSP_ARROW_KEYS);
+	m_PeriodLimit->SetRange(0, 1000);
+	m_PeriodLimit->SetValue(64);
+
+	wxGridSizer* sizerTargets = new wxGridSizer(2, 4, 0, 6);
 	sizerTargets->Add(textPopulationTarget, 0);
 	sizerTargets->Add(textGenerationTarget, 0);
 	sizerTargets->Add(textEpochsTarget, 0);
+	sizerTargets->Add(textPeriodLimit, 0);
 	sizerTargets->Add(m_PopulationTarget, 0, wxEXPAND);
 	sizerTargets->Add(m_GenerationTarget, 0, wxEXPAND);
 	sizerTargets->Add(m_EpochsTarget, 0, wxEXPAND);
+	sizerTargets->Add(m_PeriodLimit, 0, wxEXPAND);
 
 	// SELECTION
 	wxStaticText* textSelection = new wxStaticText(this, wxID_ANY, "Selection Method");
@@ -167,6 +205,51 @@ void AlgorithmParameters::BuildInterface()
 	sizerSelection->Add(textSelection, 0, wxALIGN_CENTER_VERTICAL);
 	sizerSelection->Add(m_SelectionMethod, 0, wxEXPAND | wxLEFT, 8);
 
+	// ISLANDS
+	wxStaticText* textIslands = new wxStaticText(this, wxID_ANY, "Islands");
+	textIslands->SetToolTip("1 - 64");
+	m_Islands = new wxSpinCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxSP_WRAP | wxSP_ARROW_KEYS);
+	m_Islands->SetRange(1, 64);
+	m_Islands->SetValue(1);
+
+	wxStaticText* textMigrationInterval = new wxStaticText(this, wxID_ANY, "Migration Interval");
+	textMigrationInterval->SetToolTip("1 - 1,000");
+	m_MigrationInterval = new wxSpinCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxSP_WRAP | wxSP_ARROW_KEYS);
+	m_MigrationInterval->SetRange(1, 1000);
+	m_MigrationInterval->SetValue(5);
+
+	wxStaticText* textMigrants = new wxStaticText(this, wxID_ANY, "Migrants");
+	textMigrants->SetToolTip("1 - 100");
+	m_Migrants = new wxSpinCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxSP_WRAP | wxSP_ARROW_KEYS);
+	m_Migrants->SetRange(1, 100);
+	m_Migrants->SetValue(2);
+
+	wxStaticText* textMigrationTopology = new wxStaticText(this, wxID_ANY, "Migration Topology");
+	m_MigrationTopology = new wxComboBox(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, {}, wxCB_READONLY | wxCB_DROPDOWN);
+	m_MigrationTopology->Set({ "Ring", "Fully Connected" });
+	m_MigrationTopology->SetValue("Ring");
+
+	wxGridSizer* sizerIslands = new wxGridSizer(2, 4, 0, 6);
+	sizerIslands->Add(textIslands, 0);
+	sizerIslands->Add(textMigrationInterval, 0);
+	sizerIslands->Add(textMigrants, 0);
+	sizerIslands->Add(textMigrationTopology, 0);
+	sizerIslands->Add(m_Islands, 0, wxEXPAND);
+	sizerIslands->Add(m_MigrationInterval, 0, wxEXPAND);
+	sizerIslands->Add(m_Migrants, 0, wxEXPAND);
+	sizerIslands->Add(m_MigrationTopology, 0, wxEXPAND);
+
+	// CHECKPOINTS
+	wxStaticText* textCheckpointInterval = new wxStaticText(this, wxID_ANY, "Checkpoint Interval");
+	textCheckpointInterval->SetToolTip("0 - 10,000 (0 = only when asked for)");
+	m_CheckpointInterval = new wxSpinCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxSP_WRAP | wxSP_ARROW_KEYS);
+	m_CheckpointInterval->SetRange(0, 10000);
+	m_CheckpointInterval->SetValue(0);
+
+	wxBoxSizer* sizerCheckpoint = new wxBoxSizer(wxHORIZONTAL);
+	sizerCheckpoint->Add(textCheckpointInterval, 0, wxALIGN_CENTER_VERTICAL);
+	sizerCheckpoint->Add(m_CheckpointInterval, 0, wxEXPAND | wxLEFT, 8);
+
 	//wxStaticBoxSizer* sizer = new wxStaticBoxSizer(wxVERTICAL, this, "Algorithm Parameters");
 	wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
 	sizer->Add(sizerP, 0, wxLEFT, 8);
@@ -174,6 +257,10 @@ void AlgorithmParameters::BuildInterface()
 	sizer->Add(sizerTargets, 0, wxLEFT, 8);
 	sizer->AddSpacer(16);
 	sizer->Add(sizerSelection, 0, wxLEFT, 8);
+	sizer->AddSpacer(16);
+	sizer->Add(sizerIslands, 0, wxLEFT, 8);
+	sizer->AddSpacer(16);
+	sizer->Add(sizerCheckpoint, 0, wxLEFT, 8);
 
 	SetSizer(sizer);
 }
@@ -15,12 +15,20 @@ public:
 	int GetGenerationTarget();
 	int GetPopulationTarget();
 	int GetEpochsTarget();
+	int GetPeriodLimit();
 
 	double GetGenerationMultiplier();
 	double GetPopulationMultiplier();
 	double GetInitialSizeMultiplier();
 
 	wxString GetSelectionMethod();
+
+	int GetIslands();
+	int GetMigrationInterval();
+	int GetMigrants();
+	wxString GetMigrationTopology();
+
+	int GetCheckpointInterval();
 private:
 	wxSpinCtrl* m_PopulationSize = nullptr;
 	wxSpinCtrlDouble* m_ProbabilityMutation = nullptr;
@@ -33,8 +41,16 @@ private:
 	wxSpinCtrl* m_GenerationTarget = nullptr;
 	wxSpinCtrl* m_PopulationTarget = nullptr;
 	wxSpinCtrl* m_EpochsTarget = nullptr;
+	wxSpinCtrl* m_PeriodLimit = nullptr;
 	wxComboBox* m_SelectionMethod = nullptr;
 
+	wxSpinCtrl* m_Islands = nullptr;
+	wxSpinCtrl* m_MigrationInterval = nullptr;
+	wxSpinCtrl* m_Migrants = nullptr;
+	wxComboBox* m_MigrationTopology = nullptr;
+
+	wxSpinCtrl* m_CheckpointInterval = nullptr;
+
 	void BuildInterface();
 };
 
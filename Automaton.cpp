@@ -0,0 +1,136 @@
+#include "Automaton.h"
+#include "Interpreter.h"
+#include "Sizes.h"
+
+#include <algorithm>
+#include <random>
+
+Automaton::Automaton(int nThreads) : m_ThreadPool(nThreads)
+{
+	// nothing to run until a pattern is loaded
+	m_RuleSet = std::make_shared<const RuleSet>();
+}
+
+Automaton::~Automaton()
+{
+}
+
+std::string Automaton::Load(PatternFile::Pattern& pattern)
+{
+	// names are case insensitive, the editors turn everything uppercase
+	auto upper = [](std::string s) { std::transform(s.begin(), s.end(), s.begin(), ::toupper); return s; };
+
+	// patterns without a size take the default one
+	int rows = pattern.rows ? pattern.rows : Sizes::N_ROWS;
+	int cols = pattern.cols ? pattern.cols : Sizes::N_COLS;
+
+	std::vector<std::string> states = { "FREE" };
+	for (auto& state : pattern.states) states.push_back(upper(state));
+
+	m_Registry = StateRegistry(states);
+
+	std::string text = upper(pattern.rules);
+
+	Interpreter interpreter;
+	std::vector<std::pair<int, std::string>> invalid = interpreter.Process(text);
+
+	if (invalid.size()) return invalid.front().second + " at position " + std::to_string(invalid.front().first);
+
+	m_RuleSet = std::make_shared<const RuleSet>(interpreter.GetTransitions(), states, pattern.neighbors, m_Registry);
+
+	if (m_RuleSet->GetError().size()) return m_RuleSet->GetError() + " at rule number " + std::to_string(m_RuleSet->GetErrorRule() + 1);
+
+	m_Engine.Compile(*m_RuleSet);
+
+	m_Cells.Resize(rows, cols);
+
+	StateId border = m_Registry.Find(upper(pattern.border));
+	if (pattern.topology == TOPOLOGY_BORDER && border == STATE_INVALID) return "Invalid border state " + pattern.border + " in [SIZE]";
+
+	m_Cells.SetTopology(pattern.topology, pattern.topology == TOPOLOGY_BORDER ? border : STATE_FREE);
+
+	// same coordinates as the grid: relative to its center, whatever is outside of it is lost
+	for (auto& cell : pattern.cells)
+	{
+		long long x = cell.first.first + cols / 2;
+		long long y = cell.first.second + rows / 2;
+
+		StateId state = m_Registry.Find(upper(cell.second));
+		if (state == STATE_INVALID) return "Invalid state " + cell.second + " in [CELLS]";
+
+		if (x >= 0 && x < cols && y >= 0 && y < rows) m_Cells.Set(x, y, state);
+	}
+
+	m_Cells.Commit();
+
+	return "";
+}
+
+void Automaton::Populate(double probability, unsigned int seed)
+{
+	m_Cells.Clear();
+
+	// nothing but "FREE"
+	if (m_Registry.Size() < 2) return;
+
+	// a fixed seed gives the same cells every time
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<double> chance(0.0, 1.0);
+	std::uniform_int_distribution<int> state(1, m_Registry.Size() - 1);
+
+	for (int k = 0; k < m_Cells.GetSize(); k++)
+	{
+		if (chance(generator) < probability) m_Cells.Set(k, state(generator));
+	}
+
+	m_Cells.Commit();
+}
+
+bool Automaton::Step()
+{
+	// a few bands of rows for every thread, the same as the grid
+	m_Engine.Step(*m_RuleSet, m_Cells, m_ThreadPool, m_ThreadPool.GetSize() * 4, m_Changes);
+
+	for (auto& change : m_Changes) m_Cells.Set(change.cell, change.to);
+
+	// there's no undo history here -> keep the back buffer in sync
+	m_Cells.Commit();
+	m_Engine.Commit(m_Changes, m_Cells);
+
+	return m_Changes.size();
+}
+
+std::vector<Change>& Automaton::GetChanges()
+{
+	return m_Changes;
+}
+
+Universe& Automaton::GetCells()
+{
+	return m_Cells;
+}
+
+StateRegistry& Automaton::GetRegistry()
+{
+	return m_Registry;
+}
+
+const std::vector<std::pair<std::string, Transition>>& Automaton::GetRules()
+{
+	return m_RuleSet->GetRules();
+}
+
+const RuleSet& Automaton::GetRuleSet()
+{
+	return *m_RuleSet;
+}
+
+RuleEngine& Automaton::GetEngine()
+{
+	return m_Engine;
+}
+
+ThreadPool& Automaton::GetThreadPool()
+{
+	return m_ThreadPool;
+}
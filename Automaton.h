@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <unordered_set>
+#include <memory>
+
+#include "Transition.h"
+#include "StateRegistry.h"
+#include "RuleSet.h"
+#include "Universe.h"
+#include "RuleEngine.h"
+#include "ThreadPool.h"
+#include "PatternFile.h"
+
+// states, rules and cells of a pattern, with everything needed to run it and nothing
+// that needs a window; used by the command line tools
+class Automaton
+{
+public:
+	// 0 threads = one for every hardware thread
+	Automaton(int nThreads = 0);
+	~Automaton();
+
+	// "" if the pattern can run, otherwise what's wrong with it
+	std::string Load(PatternFile::Pattern& pattern);
+
+	// same as populating the grid: every cell gets a random state (other than "FREE") with the given probability
+	void Populate(double probability, unsigned int seed);
+
+	// one generation; false if nothing changed
+	bool Step();
+
+	std::vector<Change>& GetChanges();
+	Universe& GetCells();
+	StateRegistry& GetRegistry();
+	const std::vector<std::pair<std::string, Transition>>& GetRules();
+
+	// what Step() runs on, so the rule engine can be timed on its own
+	const RuleSet& GetRuleSet();
+	RuleEngine& GetEngine();
+	ThreadPool& GetThreadPool();
+private:
+	StateRegistry m_Registry;
+	std::shared_ptr<const RuleSet> m_RuleSet;
+
+	Universe m_Cells;
+	RuleEngine m_Engine;
+	ThreadPool m_ThreadPool;
+
+	std::vector<Change> m_Changes;
+};
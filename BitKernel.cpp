@@ -0,0 +1,338 @@
+#include "BitKernel.h"
+
+#include <algorithm>
+
+BitKernel::BitKernel()
+{
+}
+
+BitKernel::~BitKernel()
+{
+}
+
+bool BitKernel::Prepare(const std::vector<std::pair<std::string, Transition>>& rules, RuleCompiler& compiler, Universe& cells)
+{
+	// find the only state besides "FREE"
+	StateId state = STATE_INVALID;
+	bool hasFree = false;
+	bool hasState = false;
+
+	for (auto& rule : rules)
+	{
+		std::vector<StateId> ids = rule.second.stateIds;
+		ids.push_back(rule.second.fromId);
+		ids.push_back(rule.second.stateId);
+
+		for (auto& id : ids)
+		{
+			if (id == STATE_INVALID) return false;
+			if (id == STATE_FREE) continue;
+
+			if (state == STATE_INVALID) state = id;
+			else if (id != state) return false;
+		}
+
+		if (rule.second.fromId == STATE_FREE) hasFree = true;
+		else hasState = true;
+	}
+
+	if (state == STATE_INVALID) return false;
+
+	// cells of states without rules would have to be counted as well
+	if (cells.GetPopulation() != cells.CountState(state)) return false;
+
+	// same for a border of a third state
+	m_Topology = cells.GetTopology();
+	m_Border = cells.GetBorder();
+	if (m_Topology == TOPOLOGY_BORDER && m_Border != STATE_FREE && m_Border != state) return false;
+
+	if (hasFree && !compiler.IsCompiled(STATE_FREE)) return false;
+	if (hasState && !compiler.IsCompiled(state)) return false;
+
+	// both states have to count the same neighborhood (or nothing at all)
+	std::vector<int> directions;
+	bool found = false;
+
+	StateId froms[2] = { STATE_FREE, state };
+	bool has[2] = { hasFree, hasState };
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (!has[i] || compiler.GetCounted(froms[i]).empty()) continue;
+
+		if (!found) directions = compiler.GetDirections(froms[i]);
+		else if (directions != compiler.GetDirections(froms[i])) return false;
+
+		found = true;
+	}
+
+	if (directions.size() > COUNT_MAX) return false;
+
+	// inside the universe every neighbor that isn't of this state is "FREE",
+	// so the results only depend on the number of neighbors of this state
+	const int n = directions.size();
+	std::vector<int> counts(std::max<int>(state, STATE_FREE) + 1, 0);
+
+	m_Birth = 0;
+	m_Survival = 0;
+	m_AppliedFree = 0;
+	m_AppliedState = 0;
+	m_Identity = false;
+
+	for (int c = 0; c <= n; c++)
+	{
+		counts[state] = c;
+		counts[STATE_FREE] = n - c;
+
+		StateId nextFree = hasFree ? compiler.Lookup(STATE_FREE, counts) : STATE_INVALID;
+		StateId nextState = hasState ? compiler.Lookup(state, counts) : STATE_INVALID;
+
+		if (nextFree == state) m_Birth |= 1u << c;
+		if (nextFree != STATE_INVALID) m_AppliedFree |= 1u << c;
+		if (nextState != STATE_FREE) m_Survival |= 1u << c;
+		if (nextState != STATE_INVALID) m_AppliedState |= 1u << c;
+	}
+
+	// near the border fewer neighbors are counted, so check those counts as well
+	for (int s = 0; s <= n && !m_Identity; s++)
+	{
+		for (int f = 0; f + s <= n; f++)
+		{
+			counts[state] = s;
+			counts[STATE_FREE] = f;
+
+			if (hasFree && compiler.Lookup(STATE_FREE, counts) == STATE_FREE) m_Identity = true;
+			if (hasState && compiler.Lookup(state, counts) == state) m_Identity = true;
+		}
+	}
+
+	m_Directions = directions;
+
+	// bits are out of date (or a step was never written back)
+	if (!m_Loaded || m_Pending || state != m_State || cells.GetVersion() != m_Version
+		|| cells.GetRows() != m_Rows || cells.GetCols() != m_Cols)
+	{
+		m_State = state;
+		Load(cells);
+	}
+
+	return true;
+}
+
+StateId BitKernel::GetState()
+{
+	return m_State;
+}
+
+void BitKernel::Step(RuleCompiler& compiler, ThreadPool& pool, std::vector<Change>& applied)
+{
+	// every thread gets a few bands of rows
+	const int nBands = std::max(1, std::min(m_Rows, pool.GetSize() * 4));
+	const int bandRows = (m_Rows + nBands - 1) / nBands;
+
+	pool.For(nBands, std::bind(&BitKernel::StepBand, this, std::placeholders::_1, bandRows));
+
+	// neighbors outside the universe depend on the topology
+	StepBorder(compiler);
+
+	// merged in order of bands, so the changes come out in order of cells
+	std::vector<std::vector<Change>> bandApplied(nBands);
+	pool.For(nBands, std::bind(&BitKernel::CollectBand, this, std::placeholders::_1, bandRows, std::ref(bandApplied)));
+
+	size_t size = applied.size();
+	for (auto& it : bandApplied) size += it.size();
+	applied.reserve(size);
+
+	for (auto& it : bandApplied) applied.insert(applied.end(), it.begin(), it.end());
+
+	std::swap(m_Front, m_Back);
+	m_Pending = true;
+}
+
+void BitKernel::Commit(Universe& cells)
+{
+	if (!m_Pending) return;
+
+	m_Version = cells.GetVersion();
+	m_Pending = false;
+}
+
+void BitKernel::Load(Universe& cells)
+{
+	m_Rows = cells.GetRows();
+	m_Cols = cells.GetCols();
+	m_Words = (m_Cols + 63) / 64;
+
+	m_Front.assign(m_Rows * m_Words, 0);
+	m_Back.assign(m_Rows * m_Words, 0);
+	m_Applied.assign(m_Rows * m_Words, 0);
+
+	for (int y = 0; y < m_Rows; y++)
+	{
+		for (int x = 0; x < m_Cols; x++)
+		{
+			if (cells.Get(x, y) == m_State) m_Front[y * m_Words + x / 64] |= uint64_t(1) << (x % 64);
+		}
+	}
+
+	m_Version = cells.GetVersion();
+	m_Loaded = true;
+	m_Pending = false;
+}
+
+void BitKernel::StepBand(int band, int bandRows)
+{
+	const int n = m_Directions.size();
+	const int W = m_Words;
+
+	for (int y = band * bandRows; y < std::min(m_Rows, (band + 1) * bandRows); y++)
+	{
+		for (int w = 0; w < W; w++)
+		{
+			// 4-bit counter for every one of the 64 cells
+			uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+
+			for (int i = 0; i < n; i += 2)
+			{
+				uint64_t a = GetShifted(y + DIRECTION_DY[m_Directions[i]], w, DIRECTION_DX[m_Directions[i]]);
+				uint64_t b = 0;
+				if (i + 1 < n) b = GetShifted(y + DIRECTION_DY[m_Directions[i + 1]], w, DIRECTION_DX[m_Directions[i + 1]]);
+
+				// full adder on the lowest bit, the carry ripples up the rest
+				uint64_t carry = (c0 & a) | (c0 & b) | (a & b);
+				c0 ^= a ^ b;
+
+				uint64_t carry1 = c1 & carry;
+				c1 ^= carry;
+				uint64_t carry2 = c2 & carry1;
+				c2 ^= carry1;
+				c3 ^= carry2;
+			}
+
+			uint64_t birth = 0, survival = 0, appliedFree = 0, appliedState = 0;
+			for (int c = 0; c <= n; c++)
+			{
+				uint64_t equal = ((c & 1) ? c0 : ~c0) & ((c & 2) ? c1 : ~c1) & ((c & 4) ? c2 : ~c2) & ((c & 8) ? c3 : ~c3);
+
+				if (m_Birth >> c & 1) birth |= equal;
+				if (m_Survival >> c & 1) survival |= equal;
+				if (m_AppliedFree >> c & 1) appliedFree |= equal;
+				if (m_AppliedState >> c & 1) appliedState |= equal;
+			}
+
+			uint64_t current = m_Front[y * W + w];
+			uint64_t mask = GetMask(w);
+
+			m_Back[y * W + w] = ((~current & birth) | (current & survival)) & mask;
+			if (m_Identity) m_Applied[y * W + w] = ((~current & appliedFree) | (current & appliedState)) & mask;
+		}
+	}
+}
+
+void BitKernel::CollectBand(int band, int bandRows, std::vector<std::vector<Change>>& bandApplied)
+{
+	const int W = m_Words;
+
+	for (int y = band * bandRows; y < std::min(m_Rows, (band + 1) * bandRows); y++)
+	{
+		for (int w = 0; w < W; w++)
+		{
+			uint64_t current = m_Front[y * W + w];
+			uint64_t next = m_Back[y * W + w];
+			uint64_t bits = current ^ next;
+			if (m_Identity) bits |= m_Applied[y * W + w];
+
+			while (bits)
+			{
+				int b = 0;
+				while (!(bits >> b & 1)) b++;
+				bits &= bits - 1;
+
+				int k = y * m_Cols + w * 64 + b;
+				StateId from = (current >> b & 1) ? m_State : STATE_FREE;
+				StateId to = (next >> b & 1) ? m_State : STATE_FREE;
+
+				bandApplied[band].push_back({ k, from, to });
+			}
+		}
+	}
+}
+
+uint64_t BitKernel::GetMask(int w)
+{
+	// bits past the last column stay empty
+	int used = m_Cols - w * 64;
+	if (used >= 64) return ~uint64_t(0);
+
+	return (uint64_t(1) << used) - 1;
+}
+
+uint64_t BitKernel::GetShifted(int y, int w, int dx)
+{
+	// bit i holds the cell dx columns away from column w * 64 + i
+	if (y < 0 || y >= m_Rows) return 0;
+
+	const uint64_t* row = &m_Front[y * m_Words];
+
+	if (dx < 0) return (row[w] << 1) | (w > 0 ? row[w - 1] >> 63 : 0);
+	if (dx > 0) return (row[w] >> 1) | (w + 1 < m_Words ? row[w + 1] << 63 : 0);
+
+	return row[w];
+}
+
+void BitKernel::StepBorder(RuleCompiler& compiler)
+{
+	std::vector<int> counts(std::max<int>(m_State, STATE_FREE) + 1, 0);
+
+	for (int y = 0; y < m_Rows; y++)
+	{
+		// only the first and last column of the rows in between
+		int step = (y == 0 || y == m_Rows - 1) ? 1 : std::max(1, m_Cols - 1);
+
+		for (int x = 0; x < m_Cols; x += step)
+		{
+			int w = y * m_Words + x / 64;
+			uint64_t bit = uint64_t(1) << (x % 64);
+
+			StateId state = (m_Front[w] & bit) ? m_State : STATE_FREE;
+			StateId result = LookupCell(compiler, state, x, y, counts);
+			StateId next = result == STATE_INVALID ? state : result;
+
+			if (next == m_State) m_Back[w] |= bit;
+			else m_Back[w] &= ~bit;
+
+			if (m_Identity)
+			{
+				if (result != STATE_INVALID) m_Applied[w] |= bit;
+				else m_Applied[w] &= ~bit;
+			}
+		}
+	}
+}
+
+StateId BitKernel::LookupCell(RuleCompiler& compiler, StateId state, int x, int y, std::vector<int>& counts)
+{
+	if (!compiler.IsCompiled(state)) return STATE_INVALID;
+
+	std::fill(counts.begin(), counts.end(), 0);
+
+	for (int d : m_Directions)
+	{
+		int k = Universe::Map(x + DIRECTION_DX[d], y + DIRECTION_DY[d], m_Rows, m_Cols, m_Topology);
+
+		// nothing past the edges, or a border
+		if (k == -1)
+		{
+			if (m_Topology == TOPOLOGY_BORDER) counts[m_Border]++;
+			continue;
+		}
+
+		int nx = k % m_Cols;
+		int ny = k / m_Cols;
+
+		bool set = m_Front[ny * m_Words + nx / 64] >> (nx % 64) & 1;
+		counts[set ? m_State : STATE_FREE]++;
+	}
+
+	return compiler.Lookup(state, counts);
+}
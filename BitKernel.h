@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "Transition.h"
+#include "StateRegistry.h"
+#include "Universe.h"
+#include "RuleCompiler.h"
+#include "ThreadPool.h"
+
+// applies rule sets with only two states ("FREE" and another one) on a
+// bit-packed copy of the cells, counting neighbors 64 cells at a time
+class BitKernel
+{
+public:
+	BitKernel();
+	~BitKernel();
+
+	// can the (compiled) rules be applied on bits? keeps the bits in sync with the cells
+	bool Prepare(const std::vector<std::pair<std::string, Transition>>& rules, RuleCompiler& compiler, Universe& cells);
+	StateId GetState();
+
+	// every cell a rule applied on
+	void Step(RuleCompiler& compiler, ThreadPool& pool, std::vector<Change>& applied);
+
+	// the changes of the last step have been written back into the cells
+	void Commit(Universe& cells);
+private:
+	// counts are kept in 4 bit-slices
+	static const int COUNT_MAX = 15;
+
+	StateId m_State = STATE_INVALID;
+	int m_Rows = 0;
+	int m_Cols = 0;
+	int m_Words = 0;
+
+	// version of the cells the bits were copied from
+	unsigned long long m_Version = 0;
+	bool m_Loaded = false;
+	bool m_Pending = false;
+
+	std::vector<uint64_t> m_Front;
+	std::vector<uint64_t> m_Back;
+	std::vector<uint64_t> m_Applied;
+
+	// what the cells on the edges see past them (see Topology.h)
+	int m_Topology = TOPOLOGY_BOUNDED;
+	StateId m_Border = STATE_FREE;
+
+	// neighborhood counted by both states
+	std::vector<int> m_Directions;
+
+	// bit c is set if the rules give that result for c neighbors of state m_State
+	uint32_t m_Birth = 0;
+	uint32_t m_Survival = 0;
+	uint32_t m_AppliedFree = 0;
+	uint32_t m_AppliedState = 0;
+
+	// rules that keep the state of a cell still count as applied
+	bool m_Identity = false;
+
+	void Load(Universe& cells);
+	void StepBand(int band, int bandRows);
+	void CollectBand(int band, int bandRows, std::vector<std::vector<Change>>& bandApplied);
+	uint64_t GetMask(int w);
+	uint64_t GetShifted(int y, int w, int dx);
+	void StepBorder(RuleCompiler& compiler);
+	StateId LookupCell(RuleCompiler& compiler, StateId state, int x, int y, std::vector<int>& counts);
+};
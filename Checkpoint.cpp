@@ -0,0 +1,233 @@
+#include "Checkpoint.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+	const char MAGIC[4] = { 'C', 'G', 'C', 'K' };
+
+	// nothing sensible is this long, the file is corrupted
+	const int MAX_LENGTH = 1 << 30;
+}
+
+string Checkpoint::Write(const string& path) const
+{
+	// written next to the old one, which is still good if anything goes wrong
+	string temporary = path + ".tmp";
+
+	{
+		ofstream out(temporary, ios::binary | ios::trunc);
+		if (!out) return "Couldn't create " + temporary;
+
+		out.write(MAGIC, sizeof(MAGIC));
+		Put(out, (int)VERSION);
+
+		Put(out, (int)states.size());
+		for (auto& state : states) Put(out, state);
+		Put(out, (int)rules.size());
+		for (auto& rule : rules) Put(out, rule);
+		Put(out, (int)neighbors.size());
+		for (auto& neighbor : neighbors) Put(out, neighbor);
+
+		Put(out, rows);
+		Put(out, cols);
+		Put(out, topology);
+		Put(out, border);
+
+		Put(out, popSize);
+		Put(out, pc);
+		Put(out, pm);
+		Put(out, generationMultiplier);
+		Put(out, populationMultiplier);
+		Put(out, initialSizeMultiplier);
+		Put(out, epochsTarget);
+		Put(out, generationTarget);
+		Put(out, populationTarget);
+		Put(out, periodLimit);
+		Put(out, migrationInterval);
+		Put(out, nMigrants);
+		Put(out, checkpointInterval);
+		Put(out, migrationTopology);
+		Put(out, selectionMethod);
+
+		Put(out, timeElapsed);
+		Put(out, bestChromosome);
+		Put(out, bestGenes);
+
+		Put(out, (int)islands.size());
+		for (auto& island : islands)
+		{
+			Put(out, island.epoch);
+			Put(out, (int)island.evaluated);
+			Put(out, island.generator);
+
+			Put(out, (int)island.population.size());
+			for (auto& chromosome : island.population) Put(out, chromosome);
+			Put(out, island.genes);
+		}
+
+		out.flush();
+		if (!out) return "Couldn't write " + temporary;
+	}
+
+	// rename() doesn't replace an existing file everywhere
+	remove(path.c_str());
+	if (rename(temporary.c_str(), path.c_str())) return "Couldn't rename " + temporary + " to " + path;
+
+	return "";
+}
+
+string Checkpoint::Read(const string& path)
+{
+	ifstream in(path, ios::binary);
+	if (!in) return "Couldn't open " + path;
+
+	char magic[sizeof(MAGIC)];
+	in.read(magic, sizeof(magic));
+	if (!in || !equal(magic, magic + sizeof(magic), MAGIC)) return "Not a checkpoint file";
+
+	int version = 0;
+	if (!Get(in, version) || version != (int)VERSION) return "Unsupported checkpoint version " + to_string(version);
+
+	bool ok = true;
+	int count = 0;
+
+	ok = ok && Get(in, count) && count >= 0 && count < MAX_LENGTH;
+	states.assign(ok ? count : 0, "");
+	for (auto& state : states) ok = ok && Get(in, state);
+
+	ok = ok && Get(in, count) && count >= 0 && count < MAX_LENGTH;
+	rules.assign(ok ? count : 0, "");
+	for (auto& rule : rules) ok = ok && Get(in, rule);
+
+	ok = ok && Get(in, count) && count >= 0 && count < MAX_LENGTH;
+	neighbors.assign(ok ? count : 0, "");
+	for (auto& neighbor : neighbors) ok = ok && Get(in, neighbor);
+
+	ok = ok && Get(in, rows) && Get(in, cols) && Get(in, topology) && Get(in, border);
+
+	ok = ok && Get(in, popSize) && popSize > 0 && Get(in, pc) && Get(in, pm);
+	ok = ok && Get(in, generationMultiplier) && Get(in, populationMultiplier) && Get(in, initialSizeMultiplier);
+	ok = ok && Get(in, epochsTarget) && Get(in, generationTarget) && Get(in, populationTarget) && Get(in, periodLimit);
+	ok = ok && Get(in, migrationInterval) && Get(in, nMigrants) && Get(in, checkpointInterval);
+	ok = ok && Get(in, migrationTopology) && Get(in, selectionMethod);
+
+	ok = ok && Get(in, timeElapsed) && Get(in, bestChromosome) && Get(in, bestGenes);
+
+	ok = ok && Get(in, count) && count > 0 && count < MAX_LENGTH;
+	islands.assign(ok ? count : 0, Island());
+	for (auto& island : islands)
+	{
+		int evaluated = 0;
+
+		ok = ok && Get(in, island.epoch) && Get(in, evaluated) && Get(in, island.generator);
+		island.evaluated = evaluated;
+
+		ok = ok && Get(in, count) && count == popSize;
+		island.population.assign(ok ? count : 0, Chromosome());
+		for (auto& chromosome : island.population) ok = ok && Get(in, chromosome);
+
+		ok = ok && Get(in, island.genes) && island.genes.size() == (size_t)popSize * rows * cols;
+	}
+
+	if (!ok) return "The checkpoint file is incomplete or corrupted";
+
+	// every gene is the id of one of the states
+	auto valid = [this](const vector<uint8_t>& genes)
+	{
+		return all_of(genes.begin(), genes.end(), [this](uint8_t gene) { return gene < states.size(); });
+	};
+
+	for (int i = 0; i < islands.size(); i++)
+	{
+		// every slot of the genes belongs to exactly one chromosome
+		vector<char> taken(popSize, false);
+		for (auto& chromosome : islands[i].population)
+		{
+			if (chromosome.id < 0 || chromosome.id >= popSize || taken[chromosome.id]) return "The population of island " + to_string(i + 1) + " is corrupted";
+
+			taken[chromosome.id] = true;
+		}
+
+		if (!valid(islands[i].genes)) return "The genes of island " + to_string(i + 1) + " aren't states of the automaton";
+	}
+
+	if (!valid(bestGenes)) return "The genes of the best chromosome aren't states of the automaton";
+
+	return "";
+}
+
+void Checkpoint::Put(ostream& out, int value)
+{
+	int32_t v = value;
+	out.write((const char*)&v, sizeof(v));
+}
+
+void Checkpoint::Put(ostream& out, double value)
+{
+	// the exact bits, so the fitness of a chromosome is compared the same way after resuming
+	out.write((const char*)&value, sizeof(value));
+}
+
+void Checkpoint::Put(ostream& out, const string& value)
+{
+	Put(out, (int)value.size());
+	out.write(value.data(), value.size());
+}
+
+void Checkpoint::Put(ostream& out, const Chromosome& value)
+{
+	Put(out, value.id);
+	Put(out, value.avgPopulation);
+	Put(out, value.nOfGenerations);
+	Put(out, value.initialSize);
+	Put(out, value.period);
+	Put(out, value.transient);
+	Put(out, value.fitness);
+}
+
+void Checkpoint::Put(ostream& out, const vector<uint8_t>& value)
+{
+	Put(out, (int)value.size());
+	out.write((const char*)value.data(), value.size());
+}
+
+bool Checkpoint::Get(istream& in, int& value)
+{
+	int32_t v = 0;
+	if (!in.read((char*)&v, sizeof(v))) return false;
+
+	value = v;
+	return true;
+}
+
+bool Checkpoint::Get(istream& in, double& value)
+{
+	return (bool)in.read((char*)&value, sizeof(value));
+}
+
+bool Checkpoint::Get(istream& in, string& value)
+{
+	int length = 0;
+	if (!Get(in, length) || length < 0 || length >= MAX_LENGTH) return false;
+
+	value.resize(length);
+	return (bool)in.read(&value[0], length);
+}
+
+bool Checkpoint::Get(istream& in, Chromosome& value)
+{
+	return Get(in, value.id) && Get(in, value.avgPopulation) && Get(in, value.nOfGenerations) && Get(in, value.initialSize)
+		&& Get(in, value.period) && Get(in, value.transient) && Get(in, value.fitness);
+}
+
+bool Checkpoint::Get(istream& in, vector<uint8_t>& value)
+{
+	int length = 0;
+	if (!Get(in, length) || length < 0 || length >= MAX_LENGTH) return false;
+
+	value.resize(length);
+	return (bool)in.read((char*)value.data(), length);
+}
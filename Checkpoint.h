@@ -0,0 +1,82 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdint>
+
+#include "Chromosome.h"
+
+// everything needed to pick up a run of the GA where it was left: the automaton it ran on, its parameters,
+// its best chromosome and the populations of its islands, random numbers included; written as a binary
+// file made of "CGCK", the version it was written with and the values below, in this order
+class Checkpoint
+{
+public:
+	// files written with another version aren't read
+	static const uint32_t VERSION = 1;
+
+	struct Island
+	{
+		// the last epoch it got to, and if its population was evaluated by then (if not, it's evaluated again)
+		int epoch = 0;
+		bool evaluated = false;
+
+		// its default_random_engine, as written by operator<<
+		string generator;
+
+		// the genes of every slot, one after another
+		vector<Chromosome> population;
+		vector<uint8_t> genes;
+	};
+
+	// the automaton, the way it's listed in its panels
+	vector<string> states;
+	vector<string> rules;
+	vector<string> neighbors;
+	int rows = 0;
+	int cols = 0;
+	int topology = 0;
+	int border = 0;
+
+	// parameters of the GA (the population size is the one of an island)
+	int popSize = 0;
+	double pc = 0.0;
+	double pm = 0.0;
+	double generationMultiplier = 0.0;
+	double populationMultiplier = 0.0;
+	double initialSizeMultiplier = 0.0;
+	int epochsTarget = 0;
+	int generationTarget = 0;
+	int populationTarget = 0;
+	int periodLimit = 0;
+	int migrationInterval = 0;
+	int nMigrants = 0;
+	int checkpointInterval = 0;
+	string migrationTopology;
+	string selectionMethod;
+
+	// seconds
+	int timeElapsed = 0;
+
+	Chromosome bestChromosome;
+	vector<uint8_t> bestGenes;
+
+	vector<Island> islands;
+
+	// both return the error, if any; the file is only replaced once the new one is complete, and a file
+	// read is rejected unless its genes are states and the ids of every island are the slots of its genes
+	string Write(const string& path) const;
+	string Read(const string& path);
+private:
+	static void Put(ostream& out, int value);
+	static void Put(ostream& out, double value);
+	static void Put(ostream& out, const string& value);
+	static void Put(ostream& out, const Chromosome& value);
+	static void Put(ostream& out, const vector<uint8_t>& value);
+
+	static bool Get(istream& in, int& value);
+	static bool Get(istream& in, double& value);
+	static bool Get(istream& in, string& value);
+	static bool Get(istream& in, Chromosome& value);
+	static bool Get(istream& in, vector<uint8_t>& value);
+};
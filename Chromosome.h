@@ -1,24 +1,26 @@
 #pragma once
 #include <vector>
 
+#include "StateRegistry.h"
+
 using namespace std;
 
 class Chromosome
 {
 public:
+	// slot of its genes in the GenePool of its population
 	int id = -1;
 
-	vector<int> pattern;
-	vector<int> initialPattern;
-
 	int avgPopulation = 0;
 	int nOfGenerations = 0;
 	int initialSize = 0;
 
-	double fitness = 0.0;
+	// of the cycle its pattern fell into (1 for a still life, 0 if none was found)
+	// and the generations before the cycle started
+	int period = 0;
+	int transient = 0;
 
-	unordered_map<int, string> cells;
-	unordered_map<string, unordered_set<int>> statePositions;
+	double fitness = 0.0;
 
 	inline bool operator>(Chromosome& c)
 	{
@@ -0,0 +1,155 @@
+#include "DialogProfiler.h"
+#include "Colors.h"
+
+#include "wx/wx.h"
+
+#include <fstream>
+#include <algorithm>
+
+DialogProfiler::DialogProfiler(wxWindow* parent, RuleProfiler& profiler) : wxDialog(parent, wxID_ANY, "Rule Profile", wxDefaultPosition, wxDefaultSize, wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER), m_Profiler(profiler)
+{
+	SetBackgroundColour(wxColor(Colors::COLOR_MAIN_R, Colors::COLOR_MAIN_G, Colors::COLOR_MAIN_B));
+
+	Centre();
+
+	BuildInterface();
+
+	UpdateList();
+}
+
+DialogProfiler::~DialogProfiler()
+{
+}
+
+void DialogProfiler::BuildInterface()
+{
+	m_List = new wxListCtrl(this, wxID_ANY, wxDefaultPosition, wxSize(720, 320), wxLC_REPORT | wxLC_SINGLE_SEL);
+	m_List->InsertColumn(0, "#", wxLIST_FORMAT_RIGHT, 40);
+	m_List->InsertColumn(1, "Rule", wxLIST_FORMAT_LEFT, 200);
+	m_List->InsertColumn(2, "Strategy", wxLIST_FORMAT_LEFT, 96);
+	m_List->InsertColumn(3, "Time (us)", wxLIST_FORMAT_RIGHT, 72);
+	m_List->InsertColumn(4, "Candidates", wxLIST_FORMAT_RIGHT, 80);
+	m_List->InsertColumn(5, "Matches", wxLIST_FORMAT_RIGHT, 72);
+	m_List->InsertColumn(6, "Average (us)", wxLIST_FORMAT_RIGHT, 80);
+	m_List->InsertColumn(7, "Total (ms)", wxLIST_FORMAT_RIGHT, 72);
+	m_List->Bind(wxEVT_LIST_COL_CLICK, &DialogProfiler::OnColumnClick, this);
+
+	m_TextGenerations = new wxStaticText(this, wxID_ANY, "");
+
+	wxButton* refresh = new wxButton(this, wxID_ANY, "Refresh");
+	wxButton* clear = new wxButton(this, wxID_ANY, "Clear");
+	wxButton* save = new wxButton(this, wxID_ANY, "Export CSV");
+	wxButton* close = new wxButton(this, wxID_CANCEL, "Close");
+
+	refresh->Bind(wxEVT_BUTTON, &DialogProfiler::OnRefresh, this);
+	clear->Bind(wxEVT_BUTTON, &DialogProfiler::OnClear, this);
+	save->Bind(wxEVT_BUTTON, &DialogProfiler::OnExport, this);
+
+	wxBoxSizer* buttons = new wxBoxSizer(wxHORIZONTAL);
+	buttons->Add(m_TextGenerations, 1, wxALIGN_CENTER_VERTICAL);
+	buttons->Add(refresh, 0, wxLEFT, 4);
+	buttons->Add(clear, 0, wxLEFT, 4);
+	buttons->Add(save, 0, wxLEFT, 4);
+	buttons->Add(close, 0, wxLEFT, 4);
+
+	wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+	sizer->Add(m_List, 1, wxEXPAND | wxALL, 8);
+	sizer->Add(buttons, 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 8);
+
+	SetSizerAndFit(sizer);
+}
+
+void DialogProfiler::UpdateList()
+{
+	std::vector<RuleProfiler::Row> rows = m_Profiler.GetRows();
+	long long generations = m_Profiler.GetGenerations();
+
+	m_Rows.clear();
+	for (int i = 0; i < rows.size(); i++) m_Rows.push_back({ i + 1, rows[i] });
+
+	SortRows();
+
+	m_List->DeleteAllItems();
+	for (int i = 0; i < m_Rows.size(); i++)
+	{
+		RuleProfiler::Row& row = m_Rows[i].second;
+		double average = generations ? row.total.seconds * 1e6 / generations : 0;
+
+		m_List->InsertItem(i, wxString::Format("%i", m_Rows[i].first));
+		m_List->SetItem(i, 1, row.rule);
+		m_List->SetItem(i, 2, RuleProfiler::GetStrategyName(row.last.strategy));
+		m_List->SetItem(i, 3, wxString::Format("%.1f", row.last.seconds * 1e6));
+		m_List->SetItem(i, 4, wxString::Format("%lld", row.last.candidates));
+		m_List->SetItem(i, 5, wxString::Format("%lld", row.last.matches));
+		m_List->SetItem(i, 6, wxString::Format("%.1f", average));
+		m_List->SetItem(i, 7, wxString::Format("%.2f", row.total.seconds * 1e3));
+	}
+
+	m_TextGenerations->SetLabel(wxString::Format("Generations profiled: %lld", generations));
+}
+
+void DialogProfiler::SortRows()
+{
+	int column = m_SortColumn;
+	bool ascending = m_SortAscending;
+
+	std::stable_sort(m_Rows.begin(), m_Rows.end(), [column, ascending](const std::pair<int, RuleProfiler::Row>& a, const std::pair<int, RuleProfiler::Row>& b)
+	{
+		const RuleProfiler::Row& x = ascending ? a.second : b.second;
+		const RuleProfiler::Row& y = ascending ? b.second : a.second;
+
+		switch (column)
+		{
+		case 1:
+			return x.rule < y.rule;
+		case 2:
+			return x.last.strategy < y.last.strategy;
+		case 3:
+			return x.last.seconds < y.last.seconds;
+		case 4:
+			return x.last.candidates < y.last.candidates;
+		case 5:
+			return x.last.matches < y.last.matches;
+		case 6:
+		case 7:
+			return x.total.seconds < y.total.seconds;
+		default:
+			return ascending ? a.first < b.first : b.first < a.first;
+		}
+	});
+}
+
+void DialogProfiler::OnColumnClick(wxListEvent& evt)
+{
+	// same column again -> the other way around; the costs are sorted from the highest by default
+	if (evt.GetColumn() == m_SortColumn) m_SortAscending = !m_SortAscending;
+	else
+	{
+		m_SortColumn = evt.GetColumn();
+		m_SortAscending = m_SortColumn <= 2;
+	}
+
+	UpdateList();
+}
+
+void DialogProfiler::OnRefresh(wxCommandEvent& evt)
+{
+	UpdateList();
+}
+
+void DialogProfiler::OnClear(wxCommandEvent& evt)
+{
+	m_Profiler.Clear();
+
+	UpdateList();
+}
+
+void DialogProfiler::OnExport(wxCommandEvent& evt)
+{
+	wxFileDialog dialogFile(this, "Export Rule Profile", "", "", "CSV files (*.csv)|*.csv", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+
+	if (dialogFile.ShowModal() == wxID_CANCEL) return;
+
+	std::ofstream out(dialogFile.GetPath().ToStdString());
+	out << m_Profiler.ToCsv();
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "wx/dialog.h"
+#include "wx/listctrl.h"
+
+#include <vector>
+
+#include "RuleProfiler.h"
+
+// what every rule cost during the last generation and since the profile was cleared;
+// a click on a column sorts the rules by it
+class DialogProfiler : public wxDialog
+{
+public:
+	DialogProfiler(wxWindow* parent, RuleProfiler& profiler);
+	~DialogProfiler();
+private:
+	RuleProfiler& m_Profiler;
+
+	wxListCtrl* m_List = nullptr;
+	wxStaticText* m_TextGenerations = nullptr;
+
+	// number of every rule (in the order they're applied) and its profile
+	std::vector<std::pair<int, RuleProfiler::Row>> m_Rows;
+	int m_SortColumn = 0;
+	bool m_SortAscending = true;
+
+	void BuildInterface();
+	void UpdateList();
+	void SortRows();
+
+	void OnColumnClick(wxListEvent& evt);
+	void OnRefresh(wxCommandEvent& evt);
+	void OnClear(wxCommandEvent& evt);
+	void OnExport(wxCommandEvent& evt);
+};
@@ -381,7 +381,10 @@ void EditorRules::OnSave(wxCommandEvent& evt)
 	m_MenuBar->Enable(Ids::ID_MARK_PREV_RULES, false);
 
 	m_PrevText = m_TextCtrl->GetText();
-	m_InputRules->SetRules(data);
+
+	// checked against the states and the neighbors as soon as they're saved
+	std::string error = m_InputRules->SetRules(data);
+	if (error.size()) wxMessageBox("Some of the rules can't run with the current states and neighbors.\n" + error, "Warning", wxICON_WARNING);
 }
 
 void EditorRules::OnSaveClose(wxCommandEvent& evt)
@@ -451,7 +451,10 @@ void EditorStates::OnSave(wxCommandEvent& evt)
 	m_MenuBar->Enable(Ids::ID_MARK_PREV_STATES, false);
 
 	m_PrevText = m_TextCtrl->GetText();
-	m_InputStates->SetStates(data);
+
+	// rules using a state that's gone can't run anymore
+	std::string error = m_InputStates->SetStates(data);
+	if (error.size()) wxMessageBox("Some of the rules can't run with these states.\n" + error, "Warning", wxICON_WARNING);
 }
 
 void EditorStates::OnSaveClose(wxCommandEvent& evt)
@@ -0,0 +1,109 @@
+#include "FitnessCache.h"
+
+#include <cstring>
+
+FitnessCache::FitnessCache(int capacity) : m_Capacity(capacity)
+{
+}
+
+FitnessCache::~FitnessCache()
+{
+}
+
+FitnessCache::Key FitnessCache::GetKey(const uint8_t* genes, int length)
+{
+	// two multiply-xorshift lanes over 8 genes at a time, with different seeds and multipliers
+	unsigned long long h1 = 0x9E3779B97F4A7C15ULL ^ (unsigned long long)length;
+	unsigned long long h2 = 0xC2B2AE3D27D4EB4FULL + (unsigned long long)length;
+
+	int k = 0;
+	for (; k + 8 <= length; k += 8)
+	{
+		unsigned long long word;
+		memcpy(&word, genes + k, 8);
+
+		h1 = (h1 ^ word) * 0xBF58476D1CE4E5B9ULL;
+		h1 ^= h1 >> 31;
+		h2 = (h2 + word) * 0x94D049BB133111EBULL;
+		h2 ^= h2 >> 29;
+	}
+
+	if (k < length)
+	{
+		unsigned long long word = 0;
+		memcpy(&word, genes + k, length - k);
+
+		h1 = (h1 ^ word) * 0xBF58476D1CE4E5B9ULL;
+		h2 = (h2 + word) * 0x94D049BB133111EBULL;
+	}
+
+	// spread the last words over all the bits
+	h1 ^= h1 >> 33; h1 *= 0xFF51AFD7ED558CCDULL; h1 ^= h1 >> 33;
+	h2 ^= h2 >> 30; h2 *= 0xBF58476D1CE4E5B9ULL; h2 ^= h2 >> 27;
+
+	return { h1, h2 };
+}
+
+bool FitnessCache::Find(const Key& key, Entry& entry)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	m_Lookups++;
+
+	auto it = m_Index.find(key);
+	if (it == m_Index.end()) return false;
+
+	m_Hits++;
+
+	// used just now -> the last one to be dropped
+	m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+	entry = it->second->second;
+
+	return true;
+}
+
+void FitnessCache::Insert(const Key& key, const Entry& entry)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	if (m_Capacity <= 0) return;
+
+	// another thread got there first with the same pattern
+	if (m_Index.find(key) != m_Index.end()) return;
+
+	if (m_Entries.size() >= m_Capacity)
+	{
+		m_Index.erase(m_Entries.back().first);
+		m_Entries.pop_back();
+	}
+
+	m_Entries.push_front({ key, entry });
+	m_Index[key] = m_Entries.begin();
+}
+
+void FitnessCache::Clear(int capacity)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	m_Capacity = capacity;
+
+	m_Entries.clear();
+	m_Index.clear();
+
+	m_Hits = 0;
+	m_Lookups = 0;
+}
+
+long long FitnessCache::GetHits()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	return m_Hits;
+}
+
+long long FitnessCache::GetLookups()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	return m_Lookups;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <mutex>
+#include <cstdint>
+
+// results of the patterns played out during a run of the GA, so the chromosomes that come out of an
+// epoch unchanged (elites, couples without a crossover, genes without a mutation) aren't played out again;
+// once it's full, the pattern used the longest time ago makes room for the new one
+class FitnessCache
+{
+public:
+	// two independent 64 bit hashes of the genes
+	typedef std::pair<unsigned long long, unsigned long long> Key;
+
+	struct Entry
+	{
+		int nOfGenerations = 0;
+		int avgPopulation = 0;
+		int initialSize = 0;
+		int period = 0;
+		int transient = 0;
+		double fitness = 0.0;
+	};
+
+	FitnessCache(int capacity = 0);
+	~FitnessCache();
+
+	static Key GetKey(const uint8_t* genes, int length);
+
+	// can be used by several threads at the same time
+	bool Find(const Key& key, Entry& entry);
+	void Insert(const Key& key, const Entry& entry);
+
+	// empties it and sets how many patterns it keeps
+	void Clear(int capacity);
+
+	long long GetHits();
+	long long GetLookups();
+private:
+	struct KeyHash
+	{
+		inline size_t operator() (const Key& key) const { return key.first; }
+	};
+
+	int m_Capacity = 0;
+
+	// most recently used first
+	std::list<std::pair<Key, Entry>> m_Entries;
+	std::unordered_map<Key, std::list<std::pair<Key, Entry>>::iterator, KeyHash> m_Index;
+
+	long long m_Hits = 0;
+	long long m_Lookups = 0;
+
+	std::mutex m_Mutex;
+};
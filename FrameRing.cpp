@@ -0,0 +1,58 @@
+#include "FrameRing.h"
+
+FrameRing::FrameRing()
+{
+}
+
+FrameRing::~FrameRing()
+{
+}
+
+bool FrameRing::Push(std::vector<Change>& changes, int generations, int population)
+{
+	unsigned int head = m_Head.load(std::memory_order_relaxed);
+
+	// full -> the interface will have to redraw everything anyway
+	if (head - m_Tail.load(std::memory_order_acquire) == CAPACITY)
+	{
+		m_Dropped.fetch_add(generations, std::memory_order_release);
+		return false;
+	}
+
+	Frame& frame = m_Frames[head % CAPACITY];
+	frame.changes.assign(changes.begin(), changes.end());
+	frame.generations = generations;
+	frame.population = population;
+
+	m_Head.store(head + 1, std::memory_order_release);
+
+	return true;
+}
+
+bool FrameRing::Pop(Frame& frame)
+{
+	unsigned int tail = m_Tail.load(std::memory_order_relaxed);
+
+	// empty
+	if (tail == m_Head.load(std::memory_order_acquire)) return false;
+
+	Frame& slot = m_Frames[tail % CAPACITY];
+	frame.changes.swap(slot.changes);
+	frame.generations = slot.generations;
+	frame.population = slot.population;
+
+	m_Tail.store(tail + 1, std::memory_order_release);
+
+	return true;
+}
+
+int FrameRing::TakeDropped()
+{
+	return m_Dropped.exchange(0, std::memory_order_acquire);
+}
+
+void FrameRing::Clear()
+{
+	m_Tail.store(m_Head.load());
+	m_Dropped = 0;
+}
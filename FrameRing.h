@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <atomic>
+
+#include "Universe.h"
+
+// hands the generations from the generating thread (the only producer) over to the
+// interface (the only consumer) without locks; when the interface falls behind and the
+// ring is full, frames are dropped and counted instead of making the generations wait
+class FrameRing
+{
+public:
+	// the changes of one or more generations
+	struct Frame
+	{
+		std::vector<Change> changes;
+		int generations = 0;
+		int population = 0;
+	};
+
+	FrameRing();
+	~FrameRing();
+
+	// producer; false if the ring was full and the frame was dropped
+	bool Push(std::vector<Change>& changes, int generations, int population);
+
+	// consumer; the frame's old vector is given back to the ring, so no memory is allocated twice
+	bool Pop(Frame& frame);
+
+	// consumer; generations of the frames dropped since the last call (0 = none dropped)
+	int TakeDropped();
+
+	// only while nothing is pushed (the generating thread is stopped)
+	void Clear();
+private:
+	static const int CAPACITY = 8;
+
+	Frame m_Frames[CAPACITY];
+
+	// m_Head is only written by the producer, m_Tail only by the consumer
+	std::atomic<unsigned int> m_Head{ 0 };
+	std::atomic<unsigned int> m_Tail{ 0 };
+	std::atomic<int> m_Dropped{ 0 };
+};
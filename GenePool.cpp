@@ -0,0 +1,62 @@
+#include "GenePool.h"
+
+#include <algorithm>
+#include <cstring>
+
+GenePool::GenePool()
+{
+}
+
+GenePool::~GenePool()
+{
+}
+
+void GenePool::Resize(int size, int length)
+{
+	m_Size = size;
+	m_Length = length;
+
+	m_Genes.assign((size_t)size * length, 0);
+}
+
+int GenePool::GetSize() const
+{
+	return m_Size;
+}
+
+int GenePool::GetLength() const
+{
+	return m_Length;
+}
+
+void GenePool::Copy(int slot, const GenePool& from, int fromSlot)
+{
+	memcpy(Get(slot), from.Get(fromSlot), m_Length);
+}
+
+void GenePool::Cross(int slot1, int slot2, const GenePool& from, int parent1, int parent2, int begin, int end)
+{
+	uint8_t* child1 = Get(slot1);
+	uint8_t* child2 = Get(slot2);
+	const uint8_t* genes1 = from.Get(parent1);
+	const uint8_t* genes2 = from.Get(parent2);
+
+	// three runs of bytes for each of them: before the cut-points, between them and after them
+	const int middle = end - begin + 1;
+	const int after = m_Length - end - 1;
+
+	memcpy(child1, genes1, begin);
+	memcpy(child1 + begin, genes2 + begin, middle);
+	memcpy(child1 + end + 1, genes1 + end + 1, after);
+
+	memcpy(child2, genes2, begin);
+	memcpy(child2 + begin, genes1 + begin, middle);
+	memcpy(child2 + end + 1, genes2 + end + 1, after);
+}
+
+int GenePool::Count(int slot) const
+{
+	const uint8_t* genes = Get(slot);
+
+	return m_Length - std::count(genes, genes + m_Length, 0);
+}
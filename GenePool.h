@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// the genes of every chromosome of a population in one block of memory, a byte for every cell
+// (its state id, there are never more than 256 states); a chromosome is its slot in the pool
+class GenePool
+{
+public:
+	GenePool();
+	~GenePool();
+
+	// room for size chromosomes of length genes each, all of them "FREE"
+	void Resize(int size, int length);
+
+	int GetSize() const;
+	int GetLength() const;
+
+	inline uint8_t* Get(int slot) { return m_Genes.data() + (size_t)slot * m_Length; }
+	inline const uint8_t* Get(int slot) const { return m_Genes.data() + (size_t)slot * m_Length; }
+
+	// the genes of a chromosome of another pool
+	void Copy(int slot, const GenePool& from, int fromSlot);
+
+	// children of two chromosomes of another pool, with the genes from begin to end (both included) exchanged
+	void Cross(int slot1, int slot2, const GenePool& from, int parent1, int parent2, int begin, int end);
+
+	// genes that aren't "FREE"
+	int Count(int slot) const;
+private:
+	int m_Size = 0;
+	int m_Length = 0;
+
+	std::vector<uint8_t> m_Genes;
+};
@@ -6,6 +6,7 @@
 #include <thread>
 #include <chrono>
 #include <random>
+#include <cmath>
 #include <algorithm>
 
 wxBEGIN_EVENT_TABLE(Grid, wxHVScrolledWindow)
@@ -25,6 +26,9 @@ Grid::Grid(wxWindow* parent) : wxHVScrolledWindow(parent, wxID_ANY, wxDefaultPos
 	BuildInterface();
 
 	InitializeTimers();
+
+	// a generation is left halfway when the window closes
+	m_Engine.SetStop([this]() { return m_ForceClose; });
 }
 
 Grid::~Grid()
@@ -51,11 +55,10 @@ void Grid::SetSize(int size, bool center)
 
 
 
-		if (m_Cells != m_PrevCells)
+		if (m_Cells.Changed())
 		{
-			m_ToolUndo->PushBack(m_Cells, m_StatePositions, m_PrevCells, m_PrevStatePositions);
-			m_PrevCells = m_Cells;
-			m_PrevStatePositions = m_StatePositions;
+			m_ToolUndo->PushBack(m_Cells.GetChanges());
+			m_Cells.Commit();
 		}
 	}
 
@@ -128,6 +131,10 @@ void Grid::SetDimensions(int rows, int cols)
 	Sizes::N_ROWS = rows;
 	Sizes::N_COLS = cols;
 
+	m_MutexCells.lock();
+	m_Cells.Resize(Sizes::N_ROWS, Sizes::N_COLS);
+	m_MutexCells.unlock();
+
 	m_OffsetX = Sizes::N_COLS / 2;
 	m_OffsetY = Sizes::N_ROWS / 2;
 
@@ -137,45 +144,29 @@ void Grid::SetDimensions(int rows, int cols)
 	ScrollToCenter();
 }
 
-void Grid::SetCells(
-	std::unordered_map<std::pair<int, int>, std::pair<std::string, wxColour>, Hashes::PairInt> cells,
-	std::unordered_map<std::string, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> statePositions
-)
+void Grid::SetCells(std::vector<Change>& changes, bool undo)
 {
-	// which cells should be erased?
-	for (auto& it : m_PrevCells)
+	// revert (undo) or reapply (redo) the changes
+	for (auto& change : changes)
 	{
-		m_RedrawAll = false;
-
-		if (InVisibleBounds(it.first.first, it.first.second))
-		{
-			m_RedrawXYs.push_back({ it.first.first,it.first.second });
-			m_RedrawColors.push_back(wxColour("white"));
-		}
-	}
-
-	std::unordered_map<std::string, wxColor> colors = GetColors();
+		int x = change.cell % Sizes::N_COLS;
+		int y = change.cell / Sizes::N_COLS;
+		StateId state = undo ? change.from : change.to;
 
-	// update color of cells (if modified before an undo/redo operation)
-	m_Cells = std::unordered_map<std::pair<int, int>, std::pair<std::string, wxColour>, Hashes::PairInt>();
-	for (auto& cell : cells) m_Cells.insert({ cell.first, {cell.second.first, colors[cell.second.first]} });
+		m_Cells.Set(change.cell, state);
 
-	m_StatePositions = statePositions;
-	m_PrevCells = m_Cells;
-	m_PrevStatePositions = m_StatePositions;
-
-	// which cells should be redrawn?
-	for (auto& it : m_Cells)
-	{
+		// colors are looked up in the palette, so they're always up to date
 		m_RedrawAll = false;
-		if (InVisibleBounds(it.first.first, it.first.second))
+		if (InVisibleBounds(x, y))
 		{
-			m_RedrawXYs.push_back({ it.first.first,it.first.second });
-			m_RedrawColors.push_back(it.second.second);
+			m_RedrawXYs.push_back({ x,y });
+			m_RedrawColors.push_back(m_Palette[state]);
 		}
 	}
 
-	m_StatusCells->SetCountPopulation(m_Cells.size());
+	m_Cells.Commit();
+
+	m_StatusCells->SetCountPopulation(m_Cells.GetPopulation());
 
 	Refresh(false);
 	Update();
@@ -228,21 +219,27 @@ void Grid::SetStatusDelay(StatusDelay* statusDelay)
 
 bool Grid::InsertCell(int x, int y, std::string state, wxColour color, bool multiple)
 {
-	if (GetState(x, y) != "FREE")
+	return InsertCell(x, y, RegisterState(state, color), multiple);
+}
+
+bool Grid::InsertCell(int x, int y, StateId state, bool multiple)
+{
+	if (!InBounds(x, y) || state == STATE_INVALID) return false;
+
+	wxColour color = m_Palette[state];
+
+	if (GetStateId(x, y) != STATE_FREE)
 	{
 		// current cell is of state "FREE" but there's already a cell of another state
 		// on this exact position -> remove it
-		if (color == wxColour("white")) return RemoveCell(x, y, state, color, multiple);
+		if (state == STATE_FREE) return RemoveCell(x, y, multiple);
 		// position is occupied
 		else
 		{
 			// same state -> don't do anything
-			if (m_Cells[{x, y}].first == state) return false;
-
-			EraseCell(x, y);
+			if (m_Cells.Get(x, y) == state) return false;
 
-			m_Cells[{x, y}] = { state, color };
-			m_StatePositions[state].insert({ x,y });
+			m_Cells.Set(x, y, state);
 
 			if (multiple)
 			{
@@ -270,10 +267,9 @@ bool Grid::InsertCell(int x, int y, std::string state, wxColour color, bool mult
 		}
 	}
 	// position is available
-	else if (color != wxColour("white"))
+	else if (state != STATE_FREE)
 	{
-		m_Cells[{x, y}] = { state, color };
-		m_StatePositions[state].insert({ x,y });
+		m_Cells.Set(x, y, state);
 
 		if (multiple)
 		{
@@ -305,9 +301,9 @@ bool Grid::InsertCell(int x, int y, std::string state, wxColour color, bool mult
 	return false;
 }
 
-bool Grid::RemoveCell(int x, int y, std::string state, wxColour color, bool multiple)
+bool Grid::RemoveCell(int x, int y, bool multiple)
 {
-	if (GetState(x, y) != "FREE")
+	if (GetStateId(x, y) != STATE_FREE)
 	{
 		EraseCell(x, y, multiple);
 
@@ -327,21 +323,28 @@ bool Grid::RemoveCell(int x, int y, std::string state, wxColour color, bool mult
 	return false;
 }
 
-void Grid::RemoveState(std::string state, bool update)
+void Grid::RemoveState(std::string name, bool update)
 {
+	StateId state = m_Registry.Find(name);
+
 	// cells of this state have been placed on the grid
-	if (m_StatePositions.find(state) != m_StatePositions.end())
+	if (state != STATE_INVALID && state != STATE_FREE && m_Cells.CountState(state))
 	{
-		// remove every cell of this state from our map
-		for (auto& it : m_StatePositions[state])
+		// copy the positions, since the index changes while erasing
+		std::vector<int> positions = m_Cells.GetPositions(state);
+
+		// remove every cell of this state, one by one
+		for (int k : positions)
 		{
-			// remove from m_Cells, one by one
-			m_Cells.erase(it);
+			int x = k % Sizes::N_COLS;
+			int y = k / Sizes::N_COLS;
+
+			m_Cells.Set(k, STATE_FREE);
 
 			m_RedrawAll = false;
-			if (InVisibleBounds(it.first, it.second))
+			if (InVisibleBounds(x, y))
 			{
-				m_RedrawXYs.push_back({ it.first,it.second });
+				m_RedrawXYs.push_back({ x,y });
 				m_RedrawColors.push_back(wxColour("white"));
 			}
 		}
@@ -353,37 +356,37 @@ void Grid::RemoveState(std::string state, bool update)
 			Refresh(false);
 			Update();
 
-			m_StatusCells->SetCountPopulation(m_Cells.size());
+			m_StatusCells->SetCountPopulation(m_Cells.GetPopulation());
 		}
 
-		// remove the corresponding map
-		m_StatePositions[state].clear();
-		m_StatePositions.erase(state);
-
 		m_ToolUndo->Reset();
 
-		m_PrevCells = m_Cells;
-		m_PrevStatePositions = m_StatePositions;
+		m_Cells.Commit();
 	}
 }
 
 void Grid::UpdateState(std::string oldState, wxColour oldColor, std::string newState, wxColour newColor)
 {
-	// cells of this state need their names & colors updated
-	if (m_StatePositions.find(oldState) != m_StatePositions.end())
+	StateId oldId = m_Registry.Find(oldState);
+	if (oldId == STATE_INVALID) return;
+
+	// same state but a new color -> only the palette needs to change
+	if (oldState == newState)
 	{
-		// same state but a new color -> update it
-		if (oldState == newState)
+		m_Palette[oldId] = newColor;
+
+		// cells of this state need to be redrawn
+		if (oldId != STATE_FREE && m_Cells.CountState(oldId))
 		{
-			for (auto& it : m_StatePositions[oldState])
+			for (int k : m_Cells.GetPositions(oldId))
 			{
-				m_Cells[it].second = newColor;
+				int x = k % Sizes::N_COLS;
+				int y = k / Sizes::N_COLS;
 
-				// do they need to be redrawn now?
 				m_RedrawAll = false;
-				if (InVisibleBounds(it.first, it.second))
+				if (InVisibleBounds(x, y))
 				{
-					m_RedrawXYs.push_back({ it.first,it.second });
+					m_RedrawXYs.push_back({ x,y });
 					m_RedrawColors.push_back(newColor);
 				}
 			}
@@ -391,37 +394,30 @@ void Grid::UpdateState(std::string oldState, wxColour oldColor, std::string newS
 			Refresh(false);
 			Update();
 		}
-		// same color but a new state -> update it
-		else if (oldColor == newColor)
+	}
+	// same color but a new state -> only the registry needs to change
+	else if (oldColor == newColor)
+	{
+		if (m_Registry.Rename(oldState, newState)) return;
+
+		// new name is already known -> move the cells over to its id
+		if (oldId != STATE_FREE && m_Cells.CountState(oldId))
 		{
-			for (auto& it : m_StatePositions[oldState])
-			{
-				m_Cells[it].first = newState;
-				m_StatePositions[newState].insert(it);
-			}
+			StateId newId = RegisterState(newState, newColor);
 
-			m_StatePositions.erase(oldState);
+			std::vector<int> positions = m_Cells.GetPositions(oldId);
+			for (int k : positions) m_Cells.Set(k, newId);
 
 			m_ToolUndo->Reset();
 
-			m_PrevCells = m_Cells;
-			m_PrevStatePositions = m_StatePositions;
+			m_Cells.Commit();
 		}
 	}
 }
 
 bool Grid::EraseCell(int x, int y, bool multiple)
 {
-	std::string state = m_Cells[{x, y}].first;
-
-	m_Cells.erase({ x,y });
-	m_StatePositions[state].erase({ x,y });
-
-	// there are no more cells of this state anymore -> remove it from our map
-	if (m_StatePositions[state].size() == 0)
-	{
-		m_StatePositions.erase(state);
-	}
+	m_Cells.Set(x, y, STATE_FREE);
 
 	m_RedrawAll = false;
 
@@ -446,9 +442,40 @@ bool Grid::EraseCell(int x, int y, bool multiple)
 
 std::string Grid::GetState(int x, int y)
 {
-	if (m_Cells.find({ x,y }) == m_Cells.end()) return "FREE";
+	return m_Registry.GetName(GetStateId(x, y));
+}
+
+StateId Grid::GetStateId(int x, int y)
+{
+	if (!InBounds(x, y)) return STATE_FREE;
+
+	return m_Cells.Get(x, y);
+}
+
+StateId Grid::RegisterState(std::string state, wxColour color)
+{
+	StateId id = m_Registry.Intern(state);
+
+	// every id is taken
+	if (id == STATE_INVALID) return STATE_INVALID;
+
+	// the generating thread registers every state each generation -> only write what's new
+	if (id < m_Palette.size() && m_Palette[id] == color) return id;
+
+	if (id >= m_Palette.size()) m_Palette.resize(id + 1, wxColour("white"));
+	m_Palette[id] = color;
+
+	return id;
+}
+
+StateRegistry& Grid::GetRegistry()
+{
+	return m_Registry;
+}
 
-	return m_Cells[{x, y}].first;
+RuleProfiler& Grid::GetProfiler()
+{
+	return m_Profiler;
 }
 
 void Grid::Reset(bool refresh)
@@ -459,10 +486,13 @@ void Grid::Reset(bool refresh)
 		return;
 	}
 
-	m_Cells = std::unordered_map<std::pair<int, int>, std::pair<std::string, wxColour>, Hashes::PairInt>();
-	m_StatePositions = std::unordered_map<std::string, std::unordered_set<std::pair<int, int>, Hashes::PairInt>>();
-	m_PrevCells = m_Cells;
-	m_PrevStatePositions = m_StatePositions;
+	m_MutexCells.lock();
+	m_Cells.Clear();
+	m_Plane.Clear();
+	m_MutexCells.unlock();
+
+	// frames of the last generations aren't painted anymore
+	m_Frames.Clear();
 
 	m_RedrawAll = true;
 	m_JustResized = false;
@@ -494,11 +524,16 @@ void Grid::PlayUniverse()
 	m_Paused = false;
 	m_Finished = false;
 
+	m_PaceDeadline = std::chrono::steady_clock::now();
+
 	while (!m_Finished && !m_Paused && !m_ForceClose)
 	{
 		m_Generating = true;
 		NextGeneration();
 	}
+
+	// paused in the middle of k generations
+	if (!m_ForceClose) FlushGenerations();
 }
 
 void Grid::PauseUniverse()
@@ -517,14 +552,19 @@ void Grid::NextGeneration()
 		return;
 	}
 
-	std::pair<std::vector<std::pair<std::string, std::pair<int, int>>>, std::string> result = ParseAllRules();
+	// the cells were edited since the last generation
+	if (m_Cells.GetVersion() != m_HistoryVersion) ClearHistory();
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::string error = ParseAllRules();
 
 	// error
-	if (result.second.size())
+	if (error.size())
 	{
 		m_StatusControls->SetPlayButton(true);
 
-		std::string message = result.second;
+		std::string message = error;
 
 		wxRichMessageDialog dialog(
 			this, "Some of the rules appear to be invalid.", "Error",
@@ -543,18 +583,27 @@ void Grid::NextGeneration()
 
 	if (m_ForceClose) return;
 
-	UpdateGeneration(result.first);
-	UpdateCoordsHovered();
+	UpdateGeneration(m_Changes);
+
+	// a generation of a HashLife step costs only a fraction of the step
+	double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / m_StepGenerations;
+	m_StepCost = m_StepCost ? m_StepCost * 0.9 + cost * 0.1 : cost;
 
-	if (m_Cells != m_PrevCells)
+	// the bits of the last step are now the same as the cells
+	m_HashLife.Commit(m_Cells);
+	m_Plane.Commit(m_Cells);
+	m_Engine.Commit(m_Changes, m_Cells);
+
+	if (m_Cells.Changed())
 	{
-		m_ToolUndo->PushBack(m_Cells, m_StatePositions, m_PrevCells, m_PrevStatePositions);
-		m_PrevCells = m_Cells;
-		m_PrevStatePositions = m_StatePositions;
+		m_ToolUndo->PushBack(m_Cells.GetChanges());
+		m_Cells.Commit();
 	}
 
+	int period = UpdateHistory();
+
 	// universe has come to an end
-	if (result.first.empty())
+	if (m_Changes.empty() && !m_StepMoved)
 	{
 		m_Finished = true;
 		m_Paused = true;
@@ -565,12 +614,30 @@ void Grid::NextGeneration()
 	// continue with the next generation
 	else
 	{
-		m_StatusCells->UpdateCountGeneration(+1);
-		m_StatusCells->SetCountPopulation(m_Cells.size());
+		PublishGeneration();
 
-		std::this_thread::sleep_for(std::chrono::milliseconds(m_StatusDelay->GetDelay()));
+		// same cells as a few generations ago -> they'll keep on repeating
+		bool stop = false;
+		if (period && period != m_Period)
+		{
+			m_StatusCells->SetGenerationMessage(" [PERIOD " + std::to_string(period) + "]");
+
+			stop = m_StatusDelay->GetStopOnCycle();
+		}
+		m_Period = period;
+
+		if (stop)
+		{
+			m_Paused = true;
+
+			m_StatusControls->SetPlayButton(1);
+		}
+		else PaceGeneration();
 	}
 
+	// nothing comes after this generation for now, so it has to be painted
+	if (m_Paused) FlushGenerations();
+
 	m_Generating = false;
 }
 
@@ -583,15 +650,13 @@ void Grid::OnNextGeneration()
 		m_Generating = true;
 		m_Finished = false;
 
-		std::thread t(&Grid::NextGeneration, this);
-		t.detach();
+		m_ThreadPool.Post(std::bind(&Grid::NextGeneration, this));
 	}
 }
 
 void Grid::OnPlayUniverse()
 {
-	std::thread t(&Grid::PlayUniverse, this);
-	t.detach();
+	m_ThreadPool.Post(std::bind(&Grid::PlayUniverse, this));
 }
 
 void Grid::OnPopulate(double probability)
@@ -602,16 +667,17 @@ void Grid::OnPopulate(double probability)
 	{
 		Reset();
 
-		vector<pair<string, wxColour>> states;
+		vector<StateId> states;
 		for (auto& it : m_ToolStates->GetColors())
 		{
-			states.push_back(it);
+			StateId state = RegisterState(it.first, it.second);
+			if (state != STATE_INVALID) states.push_back(state);
 		}
 
 		const int statesSize = states.size();
 		if (statesSize > 1)
 		{
-			vector<pair<pair<int, int>, pair<string, wxColour>>> population;
+			vector<pair<pair<int, int>, StateId>> population;
 
 			const int n = Sizes::N_ROWS;
 			const int m = Sizes::N_COLS;
@@ -640,25 +706,20 @@ void Grid::OnPopulate(double probability)
 			{
 				// update the grid
 
-				m_Cells.clear();
-				m_StatePositions.clear();
+				m_Cells.Clear();
 
 				for (auto& cell : population)
 				{
 					int y = cell.first.first;
 					int x = cell.first.second;
 
-					string state = cell.second.first;
-					wxColour color = cell.second.second;
-
-					InsertCell(x, y, state, color, true);
+					InsertCell(x, y, cell.second, true);
 				}
 
-				if (m_Cells != m_PrevCells)
+				if (m_Cells.Changed())
 				{
-					m_ToolUndo->PushBack(m_Cells, m_StatePositions, m_PrevCells, m_PrevStatePositions);
-					m_PrevCells = m_Cells;
-					m_PrevStatePositions = m_StatePositions;
+					m_ToolUndo->PushBack(m_Cells.GetChanges());
+					m_Cells.Commit();
 				}
 			}
 		}
@@ -712,40 +773,132 @@ void Grid::ResetGenerationCount()
 	if (m_StatusCells->GetCountGeneration()) m_StatusCells->SetCountGeneration(0);
 }
 
+std::vector<std::pair<std::pair<long long, long long>, StateId>> Grid::GetPlaneCells()
+{
+	m_MutexCells.lock();
+
+	// the grid might have been edited since the last generation
+	m_Plane.Sync(m_Cells);
+	std::vector<std::pair<std::pair<long long, long long>, StateId>> cells = m_Plane.GetCells();
+
+	m_MutexCells.unlock();
+
+	for (auto& cell : cells)
+	{
+		cell.first.first -= Sizes::N_COLS / 2;
+		cell.first.second -= Sizes::N_ROWS / 2;
+	}
+
+	return cells;
+}
+
+void Grid::SetPlaneCells(std::vector<std::pair<std::pair<long long, long long>, StateId>>& cells)
+{
+	m_Plane.Clear();
+
+	for (auto& cell : cells)
+	{
+		long long x = cell.first.first + Sizes::N_COLS / 2;
+		long long y = cell.first.second + Sizes::N_ROWS / 2;
+
+		m_Plane.Set(x, y, cell.second);
+
+		// only the cells inside of the grid are shown
+		if (x >= 0 && x < Sizes::N_COLS && y >= 0 && y < Sizes::N_ROWS) InsertCell(x, y, cell.second, true);
+	}
+
+	m_MutexCells.lock();
+	m_Plane.Sync(m_Cells);
+	m_MutexCells.unlock();
+}
+
+void Grid::SetTopology(int topology, std::string border)
+{
+	if (topology == TOPOLOGY_BORDER && border.empty()) border = m_ToolStates->GetState().first;
+
+	m_MutexCells.lock();
+	m_Topology = topology;
+	m_Border = border.size() ? border : "FREE";
+	m_MutexCells.unlock();
+
+	m_StatusDelay->SetTopology(topology);
+}
+
+int Grid::GetTopology()
+{
+	return m_Topology;
+}
+
+std::string Grid::GetBorder()
+{
+	return m_Border;
+}
+
 void Grid::RefreshUpdate()
 {
 	Refresh(false);
 	Update();
 
-	m_StatusCells->SetCountPopulation(m_Cells.size());
+	m_StatusCells->SetCountPopulation(m_Cells.GetPopulation());
 }
 
 void Grid::UpdatePrev()
 {
-	m_PrevCells = m_Cells;
-	m_PrevStatePositions = m_StatePositions;
+	m_Cells.Commit();
 
-	m_StatusCells->SetCountPopulation(m_Cells.size());
+	m_StatusCells->SetCountPopulation(m_Cells.GetPopulation());
 }
 
-std::unordered_map<std::pair<int, int>, std::pair<std::string, wxColour>, Hashes::PairInt> Grid::GetCells()
+std::unordered_map<std::pair<int, int>, StateId, Hashes::PairInt> Grid::GetCells()
 {
-	return m_Cells;
+	std::unordered_map<std::pair<int, int>, StateId, Hashes::PairInt> cells;
+
+	const int N = m_Cells.GetSize();
+	for (int k = 0; k < N; k++)
+	{
+		if (m_Cells.Get(k) != STATE_FREE) cells[{ k % Sizes::N_COLS, k / Sizes::N_COLS }] = m_Cells.Get(k);
+	}
+
+	return cells;
 }
 
-std::unordered_map<std::string, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> Grid::GetStatePositions()
+std::unordered_map<StateId, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> Grid::GetStatePositions()
 {
-	return m_StatePositions;
+	std::unordered_map<StateId, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> statePositions;
+
+	const int N = m_Cells.GetSize();
+	for (int k = 0; k < N; k++)
+	{
+		if (m_Cells.Get(k) != STATE_FREE) statePositions[m_Cells.Get(k)].insert({ k % Sizes::N_COLS, k / Sizes::N_COLS });
+	}
+
+	return statePositions;
 }
 
-std::unordered_map<std::pair<int, int>, std::pair<std::string, wxColour>, Hashes::PairInt> Grid::GetPrevCells()
+std::unordered_map<std::pair<int, int>, StateId, Hashes::PairInt> Grid::GetPrevCells()
 {
-	return m_PrevCells;
+	std::unordered_map<std::pair<int, int>, StateId, Hashes::PairInt> cells;
+
+	const int N = m_Cells.GetSize();
+	for (int k = 0; k < N; k++)
+	{
+		if (m_Cells.GetPrev(k) != STATE_FREE) cells[{ k % Sizes::N_COLS, k / Sizes::N_COLS }] = m_Cells.GetPrev(k);
+	}
+
+	return cells;
 }
 
-std::unordered_map<std::string, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> Grid::GetPrevStatePositions()
+std::unordered_map<StateId, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> Grid::GetPrevStatePositions()
 {
-	return m_PrevStatePositions;
+	std::unordered_map<StateId, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> statePositions;
+
+	const int N = m_Cells.GetSize();
+	for (int k = 0; k < N; k++)
+	{
+		if (m_Cells.GetPrev(k) != STATE_FREE) statePositions[m_Cells.GetPrev(k)].insert({ k % Sizes::N_COLS, k / Sizes::N_COLS });
+	}
+
+	return statePositions;
 }
 
 std::unordered_map<std::string, wxColour>& Grid::GetColors()
@@ -788,16 +941,25 @@ wxCoord Grid::OnGetColumnWidth(size_t row) const
 
 void Grid::OnPaint(wxPaintEvent& evt)
 {
+	auto start = std::chrono::steady_clock::now();
+
 	wxAutoBufferedPaintDC dc(this);
 
 	PrepareDC(dc);
 	OnDraw(dc);
+
+	// read by the generating thread when it picks how many generations to skip
+	double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	m_PaintCost = m_PaintCost.load() * 0.9 + cost * 0.1;
 }
 
 void Grid::BuildInterface()
 {
 	SetRowColumnCount(Sizes::N_ROWS, Sizes::N_COLS);
 
+	m_Cells.Resize(Sizes::N_ROWS, Sizes::N_COLS);
+	m_Palette.push_back(wxColour("white"));
+
 	SetBackgroundStyle(wxBG_STYLE_PAINT);
 }
 
@@ -912,14 +1074,16 @@ bool Grid::ModeDraw(int x, int y, char mode)
 			}
 
 			SetFocus();
-			std::pair<std::string, wxColour> state = m_ToolStates->GetState();
+			std::pair<std::string, wxColour> selected = m_ToolStates->GetState();
+			StateId state = RegisterState(selected.first, selected.second);
+			if (state == STATE_INVALID) return false;
 
 			bool structure = false;
 
 			// fill the whole area with cells of this state
 			if (wxGetKeyState(WXK_ALT))
 			{
-				DrawStructure(x, y, state.first, state.second);
+				DrawStructure(x, y, state);
 
 				structure = true;
 			}
@@ -933,7 +1097,7 @@ bool Grid::ModeDraw(int x, int y, char mode)
 
 				if (!structure)
 				{
-					if (InsertCell(x, y, state.first, state.second));// ResetUniverse();
+					if (InsertCell(x, y, state));// ResetUniverse();
 				}
 			}
 			// holding click
@@ -941,7 +1105,7 @@ bool Grid::ModeDraw(int x, int y, char mode)
 			{
 				// mouse was dragged so fast that it didn't register
 				// some of the cells meant to be drawn -> apply fix
-				if (!structure) DrawLine(x, y, state.first, state.second);
+				if (!structure) DrawLine(x, y, state);
 			}
 		}
 		// right click -> remove a cell
@@ -955,13 +1119,13 @@ bool Grid::ModeDraw(int x, int y, char mode)
 			}
 
 			SetFocus();
-			if (GetState(x, y) == "FREE")
+			if (GetStateId(x, y) == STATE_FREE)
 			{
 				m_LastDrawn = { x,y };
 				return true;
 			}
 
-			std::pair<std::string, wxColour> state = m_Cells[{x, y}];
+			StateId state = GetStateId(x, y);
 
 			bool structure = false;
 
@@ -969,9 +1133,9 @@ bool Grid::ModeDraw(int x, int y, char mode)
 			if (wxGetKeyState(WXK_CONTROL))
 			{
 				// delete the cells with the same state as the selected cell
-				if (wxGetKeyState(WXK_ALT)) DeleteStructure(x, y, "");
+				if (wxGetKeyState(WXK_ALT)) DeleteStructure(x, y, STATE_INVALID);
 				// delete cells of any state
-				else DeleteStructure(x, y, state.first);
+				else DeleteStructure(x, y, state);
 
 				structure = true;
 			}
@@ -985,7 +1149,7 @@ bool Grid::ModeDraw(int x, int y, char mode)
 
 				if (!structure)
 				{
-					if (RemoveCell(x, y, state.first, state.second));
+					if (RemoveCell(x, y));
 				}
 			}
 			// holding click
@@ -993,17 +1157,16 @@ bool Grid::ModeDraw(int x, int y, char mode)
 			{
 				// mouse was dragged so fast that it didn't register
 				// some of the cells meant to be drawn -> apply fix
-				if (!structure) DrawLine(x, y, "FREE", wxColour("white"), true);
+				if (!structure) DrawLine(x, y, STATE_FREE, true);
 			}
 		}
 		// not doing any drawing operation anymore
 		else if (m_IsDrawing || m_IsErasing)
 		{
-			if (m_Cells != m_PrevCells)
+			if (m_Cells.Changed())
 			{
-				m_ToolUndo->PushBack(m_Cells, m_StatePositions, m_PrevCells, m_PrevStatePositions);
-				m_PrevCells = m_Cells;
-				m_PrevStatePositions = m_StatePositions;
+				m_ToolUndo->PushBack(m_Cells.GetChanges());
+				m_Cells.Commit();
 
 				ResetGenerationCount();
 			}
@@ -1029,11 +1192,10 @@ bool Grid::ModePick(int x, int y, char mode, std::string state)
 			m_IsDrawing = false;
 			m_IsErasing = false;
 
-			if (m_Cells != m_PrevCells)
+			if (m_Cells.Changed())
 			{
-				m_ToolUndo->PushBack(m_Cells, m_StatePositions, m_PrevCells, m_PrevStatePositions);
-				m_PrevCells = m_Cells;
-				m_PrevStatePositions = m_StatePositions;
+				m_ToolUndo->PushBack(m_Cells.GetChanges());
+				m_Cells.Commit();
 			}
 		}
 
@@ -1072,11 +1234,10 @@ bool Grid::ModeMove(int x, int y, char mode)
 			m_IsDrawing = false;
 			m_IsErasing = false;
 
-			if (m_Cells != m_PrevCells)
+			if (m_Cells.Changed())
 			{
-				m_ToolUndo->PushBack(m_Cells, m_StatePositions, m_PrevCells, m_PrevStatePositions);
-				m_PrevCells = m_Cells;
-				m_PrevStatePositions = m_StatePositions;
+				m_ToolUndo->PushBack(m_Cells.GetChanges());
+				m_Cells.Commit();
 			}
 		}
 
@@ -1192,34 +1353,28 @@ void Grid::OnDraw(wxDC& dc)
 		std::unordered_set<std::pair<int, int>, Hashes::PairInt> alreadyDrawn;
 		std::vector<std::pair<int, int>> beforeScrolling;
 
-		// iterate through the cells in order of their states
+		const int nRows = visibleEnd.GetRow() - visibleBegin.GetRow();
+		const int nCols = visibleEnd.GetCol() - visibleBegin.GetCol();
+
+		// copy the visible cells first, so the generating thread only waits for the copy and not for the drawing
+		m_VisibleCells.resize((size_t)std::max(0, nRows) * std::max(0, nCols));
+		m_VisibleColors.resize(m_VisibleCells.size());
+
 		m_MutexCells.lock();
-		for (auto& sp : m_StatePositions)
+		for (int y = visibleBegin.GetRow(); y < visibleEnd.GetRow(); y++)
 		{
-			brush.SetColour(m_Cells[{sp.second.begin()->first, sp.second.begin()->second}].second);
-			dc.SetBrush(brush);
-
-			// redraw only the cells affected by the scroll
-			for (auto& it : sp.second)
+			for (int x = visibleBegin.GetCol(); x < visibleEnd.GetCol(); x++)
 			{
-				// the cell state before scrolling
-				int x = it.first;
-				int y = it.second;
-
-				// visible
-				if (InVisibleBounds(x, y))
-				{
-					alreadyDrawn.insert({ x,y });
+				int i = (y - visibleBegin.GetRow()) * nCols + x - visibleBegin.GetCol();
 
-					dc.DrawRectangle(x * m_Size, y * m_Size, m_Size, m_Size);
-				}
+				m_VisibleCells[i] = GetStateId(x, y);
+				if (m_VisibleCells[i] != STATE_FREE) m_VisibleColors[i] = m_Palette[m_VisibleCells[i]];
 
-				// the cell after scrolling
-				x += m_JustScrolled.first;
-				y += m_JustScrolled.second;
+				// the cell that was here before scrolling
+				int px = x - m_JustScrolled.first;
+				int py = y - m_JustScrolled.second;
 
-				// visible
-				if (InVisibleBounds(x, y))
+				if (InBounds(px, py) && GetStateId(px, py) != STATE_FREE)
 				{
 					beforeScrolling.push_back({ x,y });
 				}
@@ -1227,6 +1382,24 @@ void Grid::OnDraw(wxDC& dc)
 		}
 		m_MutexCells.unlock();
 
+		// iterate through the visible cells only
+		for (int y = visibleBegin.GetRow(); y < visibleEnd.GetRow(); y++)
+		{
+			for (int x = visibleBegin.GetCol(); x < visibleEnd.GetCol(); x++)
+			{
+				int i = (y - visibleBegin.GetRow()) * nCols + x - visibleBegin.GetCol();
+
+				if (m_VisibleCells[i] != STATE_FREE)
+				{
+					alreadyDrawn.insert({ x,y });
+
+					brush.SetColour(m_VisibleColors[i]);
+					dc.SetBrush(brush);
+					dc.DrawRectangle(x * m_Size, y * m_Size, m_Size, m_Size);
+				}
+			}
+		}
+
 		// should only redraw updated cells
 		if (!m_RedrawAll)
 		{
@@ -1425,14 +1598,34 @@ void Grid::OnDraw(wxDC& dc)
 	brush.SetColour(wxColour("white"));
 	dc.SetBrush(brush);
 
+	const int nRows = visibleEnd.GetRow() - visibleBegin.GetRow();
+	const int nCols = visibleEnd.GetCol() - visibleBegin.GetCol();
+
+	// copy the visible cells first, so the generating thread only waits for the copy and not for the drawing
+	m_VisibleCells.resize((size_t)std::max(0, nRows) * std::max(0, nCols));
+	m_VisibleColors.resize(m_VisibleCells.size());
+
 	m_MutexCells.lock();
+	for (int y = 0; y < nRows; y++)
+	{
+		for (int x = 0; x < nCols; x++)
+		{
+			int i = y * nCols + x;
+
+			m_VisibleCells[i] = GetStateId(visibleBegin.GetCol() + x, visibleBegin.GetRow() + y);
+			if (m_VisibleCells[i] != STATE_FREE) m_VisibleColors[i] = m_Palette[m_VisibleCells[i]];
+		}
+	}
+	m_MutexCells.unlock();
+
 	for (int y = visibleBegin.GetRow(); y < visibleEnd.GetRow(); y++)
 	{
 		for (int x = visibleBegin.GetCol(); x < visibleEnd.GetCol(); x++)
 		{
-			if (GetState(x, y) != "FREE")
+			int i = (y - visibleBegin.GetRow()) * nCols + x - visibleBegin.GetCol();
+			if (m_VisibleCells[i] != STATE_FREE)
 			{
-				brush.SetColour(m_Cells[{x, y}].second);
+				brush.SetColour(m_VisibleColors[i]);
 				dc.SetBrush(brush);
 
 				dc.DrawRectangle(x * m_Size, y * m_Size, m_Size, m_Size);
@@ -1445,7 +1638,6 @@ void Grid::OnDraw(wxDC& dc)
 			dc.DrawRectangle(x * m_Size, y * m_Size, m_Size, m_Size);
 		}
 	}
-	m_MutexCells.unlock();
 
 	if (!m_Centered)
 	{
@@ -1469,11 +1661,10 @@ void Grid::OnMouse(wxMouseEvent& evt)
 			m_IsDrawing = false;
 			m_IsErasing = false;
 
-			if (m_Cells != m_PrevCells)
+			if (m_Cells.Changed())
 			{
-				m_ToolUndo->PushBack(m_Cells, m_StatePositions, m_PrevCells, m_PrevStatePositions);
-				m_PrevCells = m_Cells;
-				m_PrevStatePositions = m_StatePositions;
+				m_ToolUndo->PushBack(m_Cells.GetChanges());
+				m_Cells.Commit();
 			}
 		}
 
@@ -1637,7 +1828,7 @@ void Grid::OnEraseBackground(wxEraseEvent& evt)
 	// this needs to be an empty function (old wxwidgets issue)
 }
 
-void Grid::DeleteStructure(int X, int Y, std::string state)
+void Grid::DeleteStructure(int X, int Y, StateId state)
 {
 	// erase all the cells from the selected area
 
@@ -1657,10 +1848,10 @@ void Grid::DeleteStructure(int X, int Y, std::string state)
 
 		visited.insert(neighbor);
 
-		std::string neighborState = GetState(neighbor.first, neighbor.second);
+		StateId neighborState = GetStateId(neighbor.first, neighbor.second);
 
 		// doesn't matter if the structure is composed of cells of the same stats
-		if (state == "") changes += EraseCell(neighbor.first, neighbor.second, true);
+		if (state == STATE_INVALID) changes += EraseCell(neighbor.first, neighbor.second, true);
 		// otherwise erase only if they share the same state
 		else if (state == neighborState) changes += EraseCell(neighbor.first, neighbor.second, true);
 
@@ -1670,21 +1861,21 @@ void Grid::DeleteStructure(int X, int Y, std::string state)
 			int y = neighbor.second + dy[d];
 
 			// valid neighbor -> push onto stack
-			if (state == "" && GetState(x, y) != "FREE" && visited.find({ x, y }) == visited.end()) neighbors.push({ x,y });
-			else if (state == neighborState && GetState(x, y) == state && visited.find({ x, y }) == visited.end()) neighbors.push({ x,y });
+			if (state == STATE_INVALID && GetStateId(x, y) != STATE_FREE && visited.find({ x, y }) == visited.end()) neighbors.push({ x,y });
+			else if (state == neighborState && GetStateId(x, y) == state && visited.find({ x, y }) == visited.end()) neighbors.push({ x,y });
 		}
 	}
 
 	if (changes)
 	{
-		m_StatusCells->SetCountPopulation(m_Cells.size());
+		m_StatusCells->SetCountPopulation(m_Cells.GetPopulation());
 
 		Refresh(false);
 		Update();
 	}
 }
 
-void Grid::DrawStructure(int X, int Y, std::string state, wxColour color)
+void Grid::DrawStructure(int X, int Y, StateId state)
 {
 	// fill the selected area with cells of the currently selected state
 
@@ -1695,7 +1886,7 @@ void Grid::DrawStructure(int X, int Y, std::string state, wxColour color)
 	std::stack<std::pair<int, int>> neighbors;
 	neighbors.push({ X,Y });
 
-	std::string replace = GetState(X, Y);
+	StateId replace = GetStateId(X, Y);
 
 	wxPosition visibleBegin = GetVisibleBegin();
 	wxPosition visibleEnd = GetVisibleEnd();
@@ -1709,13 +1900,13 @@ void Grid::DrawStructure(int X, int Y, std::string state, wxColour color)
 
 		visited.insert(neighbor);
 
-		std::string neighborState = GetState(neighbor.first, neighbor.second);
+		StateId neighborState = GetStateId(neighbor.first, neighbor.second);
 
 		// only fill the different cells
 		if (neighborState == state) continue;
 		if (neighborState != replace) continue;
 
-		changes += InsertCell(neighbor.first, neighbor.second, state, color, true);
+		changes += InsertCell(neighbor.first, neighbor.second, state, true);
 
 		for (int d = 0; d < 4; d++)
 		{
@@ -1725,7 +1916,7 @@ void Grid::DrawStructure(int X, int Y, std::string state, wxColour color)
 			// not in visible bounds
 			if (!(x >= visibleBegin.GetCol() && x < visibleEnd.GetCol() && y >= visibleBegin.GetRow() && y < visibleEnd.GetRow())) continue;
 			// valid neighbor -> push onto stack
-			if (GetState(x, y) != state && visited.find({ x, y }) == visited.end())
+			if (GetStateId(x, y) != state && visited.find({ x, y }) == visited.end())
 			{
 				neighbors.push({ x,y });
 			}
@@ -1734,14 +1925,14 @@ void Grid::DrawStructure(int X, int Y, std::string state, wxColour color)
 
 	if (changes)
 	{
-		m_StatusCells->SetCountPopulation(m_Cells.size());
+		m_StatusCells->SetCountPopulation(m_Cells.GetPopulation());
 
 		Refresh(false);
 		Update();
 	}
 }
 
-void Grid::DrawLine(int x, int y, std::string state, wxColour color, bool remove)
+void Grid::DrawLine(int x, int y, StateId state, bool remove)
 {
 	// algorithm found on old wxwidgets version repository
 
@@ -1766,12 +1957,12 @@ void Grid::DrawLine(int x, int y, std::string state, wxColour color, bool remove
 			d = aj - (ai >> 1);
 			while (ii != x)
 			{
-				std::string currState = GetState(ii, jj);
+				StateId currState = GetStateId(ii, jj);
 				if (currState != state)
 				{
-					if (!remove && state != "FREE")
+					if (!remove && state != STATE_FREE)
 					{
-						changes += InsertCell(ii, jj, state, color, true);
+						changes += InsertCell(ii, jj, state, true);
 						m_StatusCells->UpdateCountPopulation(1);
 					}
 					else
@@ -1794,12 +1985,12 @@ void Grid::DrawLine(int x, int y, std::string state, wxColour color, bool remove
 			d = ai - (aj >> 1);
 			while (jj != y)
 			{
-				std::string currState = GetState(ii, jj);
+				StateId currState = GetStateId(ii, jj);
 				if (currState != state)
 				{
-					if (!remove && state != "FREE")
+					if (!remove && state != STATE_FREE)
 					{
-						changes += InsertCell(ii, jj, state, color, true);
+						changes += InsertCell(ii, jj, state, true);
 						m_StatusCells->UpdateCountPopulation(1);
 					}
 					else
@@ -1820,12 +2011,12 @@ void Grid::DrawLine(int x, int y, std::string state, wxColour color, bool remove
 
 		m_LastDrawn = { x,y };
 
-		std::string currState = GetState(x, y);
+		StateId currState = GetStateId(x, y);
 		if (currState != state)
 		{
-			if (!remove && state != "FREE")
+			if (!remove && state != STATE_FREE)
 			{
-				changes += InsertCell(ii, jj, state, color, true);
+				changes += InsertCell(ii, jj, state, true);
 				m_StatusCells->UpdateCountPopulation(1);
 			}
 			else
@@ -1856,426 +2047,406 @@ bool Grid::InVisibleBounds(int x, int y)
 		);
 }
 
-std::pair<std::vector<std::pair<int, int>>, std::string> Grid::ParseRule(
-	std::pair<std::string, Transition>& rule,
-	std::unordered_set<int>& visited
-)
+std::string Grid::UpdateRuleSet()
 {
-	if (m_ForceClose)
+	// the panels aren't connected yet, so there's nothing to run
+	if (!m_InputRules)
 	{
-		return { {}, "" };
+		m_MutexCells.lock();
+		m_RuleSet = std::make_shared<const RuleSet>();
+		m_RuleSetError = "";
+		m_MutexCells.unlock();
+
+		return "";
 	}
 
-	std::unordered_map<std::string, std::string> states = m_InputRules->GetInputStates()->GetStates();
-	std::unordered_set<std::string> neighbors = m_InputRules->GetInputNeighbors()->GetNeighbors();
-	std::vector<std::pair<int, int>> applied;
+	std::vector<std::string> states;
+	for (auto& it : m_InputRules->GetInputStates()->GetStates()) states.push_back(it.first);
 
-	// check if rule might contain invalid states
-	if (states.find(rule.first) == states.end()) return { {}, "<INVALID FIRST STATE>" };
-	if (states.find(rule.second.state) == states.end()) return { {}, "<INVALID SECOND STATE>" };
-	for (auto& state : rule.second.states)
-	{
-		if (states.find(state) == states.end()) return { {}, "<INVALID CONDITION STATE>" };
-	}
-	// check for neighborhood as well
-	for (auto& direction : rule.second.directions)
-	{
-		if (neighbors.find(direction) == neighbors.end()) return { {}, "<INVALID NEIGHBORHOOD>" };
-	}
+	m_MutexCells.lock();
 
-	// if state is "FREE", apply rule to all "FREE" cells
-	if (rule.first == "FREE")
-	{
-		// iterate through all cells
-		if (rule.second.all || rule.second.condition.empty())
-		{
-			const int N = Sizes::N_ROWS * Sizes::N_COLS;
+	// states that were deleted or renamed give their ids back, unless some cell still has them
+	ReleaseStates(states);
 
-			for (int i = 0; i < N; i++)
-			{
-				int x = i % Sizes::N_COLS;
-				int y = i / Sizes::N_COLS;
-				int k = y * Sizes::N_COLS + x;
+	// make sure every state has an id and a color before resolving the rules
+	for (auto& it : GetColors()) RegisterState(it.first, it.second);
 
-				if (GetState(x, y) == "FREE" && visited.find(k) == visited.end() && ApplyOnCell(x, y, rule.second, neighbors))
-				{
-					applied.push_back({ x,y });
-					visited.insert(k);
-				}
-			}
-		}
-		// decide if it's faster to iterate through all cells
-		// or through the condition states' neighbors
-		else
+	std::shared_ptr<const RuleSet> ruleSet = std::make_shared<const RuleSet>(m_InputRules->GetRules(), states, m_InputRules->GetInputNeighbors()->GetNeighbors(), m_Registry);
+
+	std::string error = ruleSet->GetError();
+	if (error.size())
+	{
+		const std::pair<std::string, Transition>& rule = ruleSet->GetRules()[ruleSet->GetErrorRule()];
+		int index = -1;
+
+		// mark the problematic rule index
+		for (int i = 0; i < m_InputRules->GetList()->GetItemCount(); i++)
 		{
-			int n1 = Sizes::N_ROWS * Sizes::N_COLS - m_Cells.size();
-			int n2 = 0;
-			for (auto& state : rule.second.states)
+			if (m_InputRules->GetList()->GetState1(i) == rule.first
+				&& m_InputRules->GetList()->GetState2(i) == rule.second.state
+				&& m_InputRules->GetList()->GetCond(i) == rule.second.condition)
 			{
-				if (m_StatePositions.find(state) == m_StatePositions.end()) continue;
-				n2 += m_StatePositions[state].size();
+				index = i;
+				break;
 			}
+		}
 
-			// faster to iterate through all cells
-			if (n1 <= n2 || rule.second.condition.empty())
-			{
-				const int N = Sizes::N_COLS * Sizes::N_ROWS;
+		if (index != -1) error += " at rule number " + std::to_string(index + 1);
+	}
 
-				for (int i = 0; i < N; i++)
-				{
-					int x = i % Sizes::N_COLS;
-					int y = i / Sizes::N_COLS;
-					int k = y * Sizes::N_COLS + x;
+	// a generation which already started keeps the rule set it took
+	m_RuleSet = ruleSet;
+	m_RuleSetError = error;
+	m_MutexCells.unlock();
 
-					if (GetState(x, y) == "FREE" && visited.find(k) == visited.end() && ApplyOnCell(x, y, rule.second, neighbors))
-					{
-						applied.push_back({ x,y });
-						visited.insert(k);
-					}
-				}
-			}
-			// faster to iterate through the condition states' neighbors
-			else
-			{
-				for (auto& state : rule.second.states)
-				{
-					if (state == "FREE")
-					{
-						const int N = Sizes::N_ROWS * Sizes::N_COLS;
-
-						for (int i = 0; i < N; i++)
-						{
-							int x = i % Sizes::N_COLS;
-							int y = i / Sizes::N_COLS;
-							int k = y * Sizes::N_COLS + x;
-
-							if (GetState(x, y) == "FREE" && visited.find(k) == visited.end() && ApplyOnCell(x, y, rule.second, neighbors))
-							{
-								applied.push_back({ x,y });
-								visited.insert(k);
-							}
-						}
-					}
-					// cells of this type are placed on grid
-					else if (m_StatePositions.find(state) != m_StatePositions.end())
-					{
-						int dx[8] = { 0,1,1,1,0,-1,-1,-1 };
-						int dy[8] = { -1,-1,0,1,1,1,0,-1 };
-
-						for (auto i = m_StatePositions.at(state).begin(); i != m_StatePositions.at(state).end(); i++)
-						{
-							int x = i->first;
-							int y = i->second;
-
-							for (int d = 0; d < 8; d++)
-							{
-								int nx = x + dx[d];
-								int ny = y + dy[d];
-								int k = ny * Sizes::N_COLS + nx;
-
-								if (InBounds(nx, ny) && GetState(nx, ny) == rule.first && visited.find(k) == visited.end() && ApplyOnCell(nx, ny, rule.second, neighbors))
-								{
-									applied.push_back({ nx,ny });
-									visited.insert(k);
-								}
-							}
-						}
-					}
-				}
-			}
-		}
+	return error;
+}
+
+void Grid::ReleaseStates(const std::vector<std::string>& states)
+{
+	std::unordered_set<std::string> listed(states.begin(), states.end());
+
+	std::vector<StateId> unlisted;
+	for (int id = STATE_FREE + 1; id < m_Registry.Size(); id++)
+	{
+		const std::string& name = m_Registry.GetName(id);
+		if (name.size() && listed.find(name) == listed.end() && !m_Cells.CountState(id)) unlisted.push_back(id);
 	}
-	// else, get all cells of that type
-	else
+
+	if (unlisted.empty()) return;
+
+	// cells that left the grid count as well
+	std::unordered_set<StateId> outside;
+	for (auto& cell : m_Plane.GetCells()) outside.insert(cell.second);
+
+	bool released = false;
+	for (StateId id : unlisted)
 	{
-		if (m_StatePositions.find(rule.first) == m_StatePositions.end()) return { {},"" };
+		if (outside.find(id) != outside.end()) continue;
 
-		// iterate through all cells
-		if (rule.second.all || rule.second.condition.empty())
-		{
-			string state = rule.first;
-			for (auto i = m_StatePositions.at(state).begin(); i != m_StatePositions.at(state).end(); i++)
-			{
-				int x = i->first;
-				int y = i->second;
-				int k = y * Sizes::N_COLS + x;
+		m_Registry.Release(m_Registry.GetName(id));
+		released = true;
+	}
 
-				if (visited.find(k) == visited.end() && ApplyOnCell(x, y, rule.second, neighbors))
-				{
-					visited.insert(k);
-					applied.push_back({ x,y });
-				}
-			}
-		}
-		// decide if it's faster to iterate through all cells
-		// or through the condition states' neighbors
-		else
-		{
-			int n1 = m_StatePositions[rule.first].size();
-			int n2 = 0;
-			for (auto& state : rule.second.states)
-			{
-				if (m_StatePositions.find(state) == m_StatePositions.end()) continue;
-				n2 += m_StatePositions[state].size();
-			}
+	// the undo history might still bring them back
+	if (released && m_ToolUndo) m_ToolUndo->Reset();
+}
 
-			// faster to iterate through all cells
-			if (n1 <= n2 || rule.second.condition.empty())
-			{
-				string state = rule.first;
-				for (auto i = m_StatePositions.at(state).begin(); i != m_StatePositions.at(state).end(); i++)
-				{
-					int x = i->first;
-					int y = i->second;
-					int k = y * Sizes::N_COLS + x;
+std::shared_ptr<const RuleSet> Grid::GetRuleSet()
+{
+	m_MutexCells.lock();
+	std::shared_ptr<const RuleSet> ruleSet = m_RuleSet;
+	m_MutexCells.unlock();
 
-					if (visited.find(k) == visited.end() && ApplyOnCell(x, y, rule.second, neighbors))
-					{
-						visited.insert(k);
-						applied.push_back({ x,y });
-					}
-				}
-			}
-			// faster to iterate through the condition states' neighbors
-			else
-			{
-				for (auto& state : rule.second.states)
-				{
-					if (state == "FREE")
-					{
-						string state = rule.first;
-						for (auto i = m_StatePositions.at(state).begin(); i != m_StatePositions.at(state).end(); i++)
-						{
-							int x = i->first;
-							int y = i->second;
-							int k = y * Sizes::N_COLS + x;
-
-							if (visited.find(k) == visited.end() && ApplyOnCell(x, y, rule.second, neighbors))
-							{
-								applied.push_back({ x,y });
-								visited.insert(k);
-							}
-						}
-					}
-					// cells of this type are placed on grid
-					else if (m_StatePositions.find(state) != m_StatePositions.end())
-					{
-						int dx[8] = { 0,1,1,1,0,-1,-1,-1 };
-						int dy[8] = { -1,-1,0,1,1,1,0,-1 };
-
-						for (auto i = m_StatePositions.at(state).begin(); i != m_StatePositions.at(state).end(); i++)
-						{
-							int x = i->first;
-							int y = i->second;
-
-							for (int d = 0; d < 8; d++)
-							{
-								int nx = x + dx[d];
-								int ny = y + dy[d];
-								int k = ny * Sizes::N_COLS + nx;
-
-								if (visited.find(k) == visited.end() && InBounds(nx, ny) && GetState(nx, ny) == rule.first && ApplyOnCell(nx, ny, rule.second, neighbors))
-								{
-									applied.push_back({ nx,ny });
-									visited.insert(k);
-								}
-							}
-						}
-					}
-				}
-			}
-		}
+	// nothing was edited yet
+	if (!ruleSet)
+	{
+		UpdateRuleSet();
+		return GetRuleSet();
 	}
 
-	return { applied, "" };
+	return ruleSet;
 }
 
-std::pair<std::vector<std::pair<std::string, std::pair<int, int>>>, std::string> Grid::ParseAllRules()
+std::string Grid::ParseAllRules()
 {
-	std::vector<std::pair<std::string, Transition>> rules = m_InputRules->GetRules();
-	std::vector<std::pair<std::string, std::pair<int, int>>> changes;
-	std::unordered_set<int> visited;
+	// built the first time, if nothing was edited yet
+	GetRuleSet();
+
+	// keeps its capacity from the last generations
+	std::vector<Change>& changes = m_Changes;
+	changes.clear();
+
+	// make sure every state has an id and a color before applying the rules
+	m_MutexCells.lock();
+	for (auto& it : GetColors()) RegisterState(it.first, it.second);
+
+	// the state of the border needs an id as well
+	StateId border = m_Registry.Find(m_Border);
+	if (m_Topology == TOPOLOGY_BORDER && border == STATE_INVALID)
+	{
+		m_MutexCells.unlock();
+		return "<INVALID BORDER STATE> " + m_Border;
+	}
+
+	// the ghosts around the cells stand for whatever is past the edges
+	m_Cells.SetTopology(m_Topology, m_Topology == TOPOLOGY_BORDER ? border : STATE_FREE);
+	m_Cells.RefreshGhosts();
+
+	// checked and resolved when the rules, the states or the neighbors were edited (see UpdateRuleSet)
+	std::shared_ptr<const RuleSet> ruleSet = m_RuleSet;
+	std::string error = m_RuleSetError;
+	m_MutexCells.unlock();
+
+	if (error.size()) return error;
 
-	for (auto& rule : rules)
+	const std::vector<std::pair<std::string, Transition>>& rules = ruleSet->GetRules();
+
+	// rules that only count neighbors are turned into lookup tables, once for every rule set
+	m_Engine.Compile(*ruleSet);
+	RuleCompiler& compiler = m_Engine.GetCompiler();
+
+	m_StepGenerations = 1;
+	m_StepMoved = false;
+	m_StepEndless = false;
+
+	auto start = std::chrono::steady_clock::now();
+
+	// an endless plane has no edges to wrap around
+	bool bounded = m_Cells.GetTopology() == TOPOLOGY_BOUNDED;
+
+	// many generations at once on an endless plane, when asked for
+	if (bounded && m_StatusDelay->GetHashLife() && m_HashLife.Prepare(rules, compiler, m_Cells))
 	{
-		std::pair<std::vector<std::pair<int, int>>, std::string> result = ParseRule(rule, visited);
+		int step = m_StatusDelay->GetStep();
 
-		// error
-		if (result.second.size())
-		{
-			int index = -1;
+		m_HashLife.SetMemoryCap(m_StatusDelay->GetMemoryCap());
+		m_StepMoved = m_HashLife.Step(step);
+		m_StepEndless = true;
+		m_StepGenerations = 1 << step;
 
-			// mark the problematic rule index
-			for (int i = 0; i < m_InputRules->GetList()->GetItemCount(); i++)
-			{
-				if (m_InputRules->GetList()->GetState1(i) == rule.first
-					&& m_InputRules->GetList()->GetState2(i) == rule.second.state
-					&& m_InputRules->GetList()->GetCond(i) == rule.second.condition)
-				{
-					index = i;
-					break;
-				}
-			}
+		m_HashLife.GetChanges(m_Cells, changes);
 
-			if (index != -1) result.second += " at rule number " + std::to_string(index + 1);
+		m_StatusDelay->SetHashLifeInfo(m_HashLife.GetNodeCount(), m_HashLife.GetHitRate());
 
-			return { {}, result.second };
-		}
-		// concatenate changes
-		else
-		{
-			std::string newstate = rule.first + "*" + rule.second.state + "*";
+		// the nodes aren't cells, so there's nothing to count as candidates
+		m_Profiler.Record(rules, RuleProfiler::STRATEGY_HASHLIFE, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 0, changes.size());
 
-			for (auto& change : result.first)
-			{
-				changes.push_back({ newstate , change });
-			}
-		}
+		return "";
+	}
+
+	// cells outside of the grid keep living, when asked for
+	if (bounded && m_StatusDelay->GetEndless() && m_Plane.Prepare(rules, compiler, m_Cells))
+	{
+		long long candidates = (long long)m_Plane.GetChunkCount() * Plane::CHUNK_SIZE * Plane::CHUNK_SIZE;
+
+		m_StepMoved = m_Plane.Step(compiler, m_ThreadPool);
+		m_StepEndless = true;
+
+		m_Plane.GetChanges(m_Cells, changes);
+
+		m_Profiler.Record(rules, RuleProfiler::STRATEGY_PLANE, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), candidates, changes.size());
+
+		return "";
 	}
 
-	return { changes,"" };
+	// everything else goes through the rules, on bits or on a few bands of rows for every thread
+	m_Engine.Step(*ruleSet, m_Cells, m_ThreadPool, m_ThreadPool.GetSize() * 4, changes, &m_Profiler);
+
+	return "";
 }
 
-bool Grid::ApplyOnCell(int x, int y, Transition& rule, std::unordered_set<std::string>& neighbors)
+void Grid::ClearHistory()
 {
-	std::unordered_map<std::string, std::string> neighborhood = GetNeighborhood({ x,y }, neighbors);
-
-	bool ruleValid = true;
-	// iterate through the chain of "OR" rules
-	for (auto& rulesOr : rule.orRules)
-	{
-		ruleValid = true;
+	m_History.clear();
+	m_HistoryGenerations.clear();
+	m_HistoryCount = 0;
+	m_Period = 0;
 
-		// iterate through the chain of "AND" rules
-		for (auto& rulesAnd : rulesOr)
-		{
-			std::vector<std::string> ruleNeighborhood = rulesAnd.first;
+	// the cells as they are now, before the next generation
+	m_History.push_back({ m_Cells.GetHash(), 0 });
+	m_HistoryGenerations[m_Cells.GetHash()] = 0;
+}
 
-			bool conditionValid = true;
-			// iterate through the chain of "OR" conditions
-			for (auto& conditionsOr : rulesAnd.second)
-			{
-				conditionValid = true;
+int Grid::UpdateHistory()
+{
+	m_HistoryVersion = m_Cells.GetVersion();
 
-				// iterate through the chain of "AND" conditions
-				for (auto& conditionsAnd : conditionsOr)
-				{
-					std::string conditionState = conditionsAnd.second;
+	if (m_StepEndless)
+	{
+		ClearHistory();
+		return 0;
+	}
 
-					int occurences = 0;
-					if (ruleNeighborhood[0] == "ALL")
-					{
-						for (auto& neighbor : neighborhood)
-							if (neighbor.second == conditionState) occurences++;
-					}
-					else for (auto& neighbor : ruleNeighborhood)
-					{
-						if (neighbors.find(neighbor) != neighbors.end())
-						{
-							if (neighborhood[neighbor] == conditionState) occurences++;
-						}
-					}
+	// the hash of the cells is kept up to date by every change, so this is O(1)
+	unsigned long long hash = m_Cells.GetHash();
+	m_HistoryCount += m_StepGenerations;
 
-					int conditionNumber = conditionsAnd.first.first;
-					int conditionType = conditionsAnd.first.second;
+	int period = 0;
 
-					switch (conditionType)
-					{
-					case TYPE_EQUAL:
-						if (occurences != conditionNumber) conditionValid = false;
-						break;
-					case TYPE_LESS:
-						if (occurences >= conditionNumber) conditionValid = false;
-						break;
-					case TYPE_MORE:
-						if (occurences <= conditionNumber) conditionValid = false;
-						break;
-					default:
-						break;
-					}
-				}
+	auto it = m_HistoryGenerations.find(hash);
+	if (it != m_HistoryGenerations.end()) period = m_HistoryCount - it->second;
 
-				if (conditionValid) break;
-			}
+	m_HistoryGenerations[hash] = m_HistoryCount;
+	m_History.push_back({ hash, m_HistoryCount });
 
-			if (!conditionValid)
-			{
-				ruleValid = false;
-				break;
-			}
-		}
+	// forget the oldest generation, unless its hash was seen again since
+	if (m_History.size() > HISTORY_SIZE)
+	{
+		auto oldest = m_History.front();
+		m_History.pop_front();
 
-		if (ruleValid) break;
+		auto found = m_HistoryGenerations.find(oldest.first);
+		if (found != m_HistoryGenerations.end() && found->second == oldest.second) m_HistoryGenerations.erase(found);
 	}
 
-	return ruleValid;
+	return period;
 }
 
-std::unordered_map<std::string, std::string> Grid::GetNeighborhood(std::pair<int, int> xy, std::unordered_set<std::string>& neighbors)
+void Grid::UpdateGeneration(std::vector<Change>& changes)
 {
-	std::unordered_map<std::string, std::string> neighborhood;
-	std::unordered_map<std::string, std::pair<int, int>> dxy(
-		{
-			{ "NW",{-1,-1} }, { "N",{0,-1} }, { "NE",{1,-1} },
-			{ "W",{-1,0} }, { "C",{0,0} }, { "E",{1,0} },
-			{ "SW",{-1,1} }, { "S",{0,1} }, { "SE",{1,1} },
-		}
-	);
+	// only the cells change here, drawing them is up to the interface (see PaintFrames)
+	m_MutexCells.lock();
+	for (auto& change : changes) m_Cells.Set(change.cell, change.to);
+	m_MutexCells.unlock();
+}
 
-	// iterate through neighbors and mark the state they have
-	for (auto& neighbor : neighbors)
+void Grid::PublishGeneration()
+{
+	if (m_PublishMark.size() != m_Cells.GetSize())
 	{
-		int x = xy.first;
-		int y = xy.second;
+		m_PublishMark.assign(m_Cells.GetSize(), 0);
+		m_Publish.clear();
+	}
+
+	for (auto& change : m_Changes)
+	{
+		if (m_PublishMark[change.cell]) continue;
 
-		std::pair<int, int> d = dxy[neighbor];
+		m_PublishMark[change.cell] = 1;
+		m_Publish.push_back(change);
+	}
+
+	m_PublishGenerations += m_StepGenerations;
+	m_PublishCount++;
 
-		int nx = x + d.first;
-		int ny = y + d.second;
+	int target = m_StatusDelay->GetTargetSpeed();
+	if (target)
+	{
+		// as many generations per frame as the target speed (or the steps, if they can't keep up with it)
+		// produce while a frame is painted, but no more frames than the screen can show
+		double speed = m_StepCost > 0 ? std::min<double>(target, 1 / m_StepCost) : target;
+		double interval = std::max(m_PaintCost.load(), FRAME_INTERVAL);
 
-		if (InBounds(nx, ny)) neighborhood.insert({ neighbor,GetState(nx,ny) });
+		m_RenderEvery = std::max(1, (int)std::ceil(speed * interval));
 	}
+	else m_RenderEvery = m_StatusDelay->GetRenderEvery();
 
-	return neighborhood;
+	if (m_PublishCount >= m_RenderEvery) FlushGenerations();
 }
 
-void Grid::UpdateGeneration(std::vector<std::pair<std::string, std::pair<int, int>>> changes)
+void Grid::FlushGenerations()
 {
-	std::unordered_map<std::string, wxColour> colors = GetColors();
+	if (!m_PublishCount) return;
 
-	m_MutexCells.lock();
-	for (auto& change : changes)
+	m_Frames.Push(m_Publish, m_PublishGenerations, m_Cells.GetPopulation());
+
+	for (auto& change : m_Publish) m_PublishMark[change.cell] = 0;
+	m_Publish.clear();
+
+	m_PublishGenerations = 0;
+	m_PublishCount = 0;
+
+	// at most one call waits for the interface, it paints every frame published until then
+	if (!m_FramesScheduled.exchange(true)) CallAfter(&Grid::PaintFrames);
+}
+
+void Grid::PaceGeneration()
+{
+	int target = m_StatusDelay->GetTargetSpeed();
+	if (!target)
 	{
-		std::string state = change.first;
+		if (m_StatusDelay->GetDelay()) std::this_thread::sleep_for(std::chrono::milliseconds(m_StatusDelay->GetDelay()));
+		return;
+	}
+
+	m_PaceDeadline += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>((double)m_StepGenerations / target));
 
-		state.pop_back();
+	// the steps are slower than the target -> don't try to catch up later
+	auto now = std::chrono::steady_clock::now();
+	if (m_PaceDeadline < now) m_PaceDeadline = now;
+	else std::this_thread::sleep_until(m_PaceDeadline);
+}
+
+void Grid::PaintFrames()
+{
+	m_FramesScheduled = false;
 
-		std::string prevState = "";
-		std::string currState = "";
-		bool separator = false;
+	if (m_ForceClose) return;
 
-		// regain information of previous and current state
-		for (int i = 0; i < state.size(); i++)
+	wxPosition visibleBegin = GetVisibleBegin();
+	wxPosition visibleEnd = GetVisibleEnd();
+	const size_t nVisible = (size_t)(visibleEnd.GetRow() - visibleBegin.GetRow()) * (visibleEnd.GetCol() - visibleBegin.GetCol());
+
+	int generations = 0;
+	int population = 0;
+	bool redrawAll = false;
+
+	// the frames are coalesced: every cell is drawn with the state it has now, not the one it had in that frame
+	while (m_Frames.Pop(m_Frame))
+	{
+		generations += m_Frame.generations;
+		population = m_Frame.population;
+
+		// cheaper to redraw everything than cell by cell
+		if (redrawAll || m_RedrawXYs.size() + m_Frame.changes.size() > nVisible)
 		{
-			if (state[i] == '*')
+			redrawAll = true;
+			continue;
+		}
+
+		m_MutexCells.lock();
+		for (auto& change : m_Frame.changes)
+		{
+			// the grid was resized in the meantime
+			if (change.cell >= m_Cells.GetSize()) continue;
+
+			int x = change.cell % Sizes::N_COLS;
+			int y = change.cell / Sizes::N_COLS;
+
+			if (InVisibleBounds(x, y))
 			{
-				separator = true;
-				continue;
+				m_RedrawXYs.push_back({ x,y });
+				m_RedrawColors.push_back(m_Palette[m_Cells.Get(change.cell)]);
 			}
+		}
+		m_MutexCells.unlock();
+	}
+
+	// the ring was full, so the frames in between are gone
+	int dropped = m_Frames.TakeDropped();
+	if (dropped)
+	{
+		generations += dropped;
+		redrawAll = true;
+
+		m_MutexCells.lock();
+		population = m_Cells.GetPopulation();
+		m_MutexCells.unlock();
+	}
 
-			if (!separator) prevState.push_back(state[i]);
-			else currState.push_back(state[i]);
+	if (generations)
+	{
+		m_StatusCells->UpdateCountGeneration(generations);
+		m_StatusCells->SetCountPopulation(population);
+
+		// speed over the last half second or so
+		auto now = std::chrono::steady_clock::now();
+		double elapsed = std::chrono::duration<double>(now - m_SpeedStart).count();
+
+		m_SpeedGenerations += generations;
+		if (elapsed >= 0.5)
+		{
+			if (elapsed < 2) m_StatusDelay->SetSpeed(m_SpeedGenerations / elapsed, m_RenderEvery);
+
+			m_SpeedGenerations = 0;
+			m_SpeedStart = now;
 		}
+	}
 
-		// insert positions into the current state map and remove them from the previous one
-		auto position = change.second;
+	UpdateCoordsHovered();
 
-		InsertCell(position.first, position.second, currState, colors[currState], true);
+	if (redrawAll)
+	{
+		m_RedrawXYs.clear();
+		m_RedrawColors.clear();
+		m_RedrawAll = true;
 	}
-	m_MutexCells.unlock();
+	// nothing visible has changed
+	else if (m_RedrawXYs.empty()) return;
+	else m_RedrawAll = false;
 
 	Refresh(false);
-	Update();
 }
 
 void Grid::OnScroll(wxScrollWinEvent& evt)
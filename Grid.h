@@ -6,7 +6,11 @@
 #include "wx/dcbuffer.h"
 
 #include <unordered_set>
+#include <deque>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
 
 #include "Ids.h"
 #include "Sizes.h"
@@ -21,6 +25,15 @@
 #include "StatusDelay.h"
 #include "InputRules.h"
 #include "Transition.h"
+#include "StateRegistry.h"
+#include "Universe.h"
+#include "RuleEngine.h"
+#include "ThreadPool.h"
+#include "HashLife.h"
+#include "Plane.h"
+#include "FrameRing.h"
+#include "RuleProfiler.h"
+#include "RuleSet.h"
 
 class ToolZoom;
 class ToolUndo;
@@ -41,10 +54,7 @@ public:
 	void ScrollToCenter(int x = Sizes::N_COLS / 2, int y = Sizes::N_ROWS / 2);
 	void SetDimensions(int rows, int cols);
 
-	void SetCells(
-		std::unordered_map<std::pair<int, int>, std::pair<std::string, wxColour>, Hashes::PairInt> cells,
-		std::unordered_map<std::string, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> statePositions
-	);
+	void SetCells(std::vector<Change>& changes, bool undo);
 
 	void SetInputRules(InputRules* inputRules);
 	void SetToolZoom(ToolZoom* toolZoom);
@@ -57,18 +67,25 @@ public:
 	void SetStatusDelay(StatusDelay* statusDelay);
 
 	bool InsertCell(int x, int y, std::string state, wxColour color, bool multiple = false);
-	bool RemoveCell(int x, int y, std::string state, wxColour color, bool multiple = false);
+	bool InsertCell(int x, int y, StateId state, bool multiple = false);
+	bool RemoveCell(int x, int y, bool multiple = false);
 	void RemoveState(std::string state, bool update = true);
 	void UpdateState(std::string oldState, wxColour oldColor, std::string newState, wxColour newColor);
 	bool EraseCell(int x, int y, bool multiple = false);
 	std::string GetState(int x, int y);
+	StateId GetStateId(int x, int y);
+	StateId RegisterState(std::string state, wxColour color);
+	StateRegistry& GetRegistry();
+
+	// time, candidates and matches of every rule during the generations
+	RuleProfiler& GetProfiler();
 
 	void RefreshUpdate();
 	void UpdatePrev();
-	std::unordered_map<std::pair<int, int>, std::pair<std::string, wxColour>, Hashes::PairInt> GetCells();
-	std::unordered_map<std::string, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> GetStatePositions();
-	std::unordered_map<std::pair<int, int>, std::pair<std::string, wxColour>, Hashes::PairInt> GetPrevCells();
-	std::unordered_map<std::string, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> GetPrevStatePositions();
+	std::unordered_map<std::pair<int, int>, StateId, Hashes::PairInt> GetCells();
+	std::unordered_map<StateId, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> GetStatePositions();
+	std::unordered_map<std::pair<int, int>, StateId, Hashes::PairInt> GetPrevCells();
+	std::unordered_map<StateId, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> GetPrevStatePositions();
 	std::unordered_map<std::string, wxColour>& GetColors();
 
 	void Reset(bool refresh = true);
@@ -88,6 +105,21 @@ public:
 
 	void DecrementGenerationCount();
 	void ResetGenerationCount();
+
+	// cells of the endless plane, relative to the center of the grid (like the cells of a saved pattern)
+	std::vector<std::pair<std::pair<long long, long long>, StateId>> GetPlaneCells();
+	void SetPlaneCells(std::vector<std::pair<std::pair<long long, long long>, StateId>>& cells);
+
+	// what the cells on the edges see past them (see Topology.h); border = state of the cells around, for TOPOLOGY_BORDER
+	// ("" = the state selected in the states tool)
+	void SetTopology(int topology, std::string border = "");
+	int GetTopology();
+	std::string GetBorder();
+
+	// checks and resolves the rules, the states and the neighbors again, after one of them was edited;
+	// "" if they can run, otherwise what's wrong and at which rule (also returned by every generation after)
+	std::string UpdateRuleSet();
+	std::shared_ptr<const RuleSet> GetRuleSet();
 private:
 	InputRules* m_InputRules = nullptr;
 	ToolZoom* m_ToolZoom = nullptr;
@@ -109,10 +141,82 @@ private:
 	bool m_Generating = false;
 	bool m_ForceClose = false;
 
-	std::unordered_map<std::pair<int, int>, std::pair<std::string, wxColour>, Hashes::PairInt> m_Cells;
-	std::unordered_map<std::string, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> m_StatePositions;
-	std::unordered_map<std::pair<int, int>, std::pair<std::string, wxColour>, Hashes::PairInt> m_PrevCells;
-	std::unordered_map<std::string, std::unordered_set<std::pair<int, int>, Hashes::PairInt>> m_PrevStatePositions;
+	// cells store state ids; names live in the registry and colors in the palette
+	StateRegistry m_Registry;
+	std::vector<wxColour> m_Palette;
+
+	// the back buffer holds the cells as they were at the last undo checkpoint
+	Universe m_Cells;
+
+	// the rules as they were after the last edit, shared with whoever runs them
+	std::shared_ptr<const RuleSet> m_RuleSet;
+	std::string m_RuleSetError = "";
+
+	// applies the rules one generation at a time, HashLife and m_Plane take its lookup tables
+	RuleEngine m_Engine;
+	HashLife m_HashLife;
+
+	// the grid is only a window into it, cells that leave the grid are kept here
+	Plane m_Plane;
+
+	// generations advanced by the last call of ParseAllRules, and whether
+	// anything changed outside of the universe (HashLife's plane and m_Plane are endless)
+	int m_StepGenerations = 1;
+	bool m_StepMoved = false;
+
+	// runs the generations and splits every one of them between its threads
+	ThreadPool m_ThreadPool;
+
+	// changes of the current generation, kept between generations so the memory is reused
+	std::vector<Change> m_Changes;
+
+	// hashes of the last generations (oldest first) and the generation each of them was seen at,
+	// so a universe that repeats itself is found in O(1); cleared whenever the cells are edited
+	static const int HISTORY_SIZE = 1024;
+	std::deque<std::pair<unsigned long long, long long>> m_History;
+	std::unordered_map<unsigned long long, long long> m_HistoryGenerations;
+	long long m_HistoryCount = 0;
+	unsigned long long m_HistoryVersion = 0;
+	int m_Period = 0;
+
+	// the grid isn't everything there is (HashLife or the endless plane), so its hash doesn't tell much
+	bool m_StepEndless = false;
+
+	// given to the cells with the next generation, once the border's state has an id
+	int m_Topology = TOPOLOGY_BOUNDED;
+	std::string m_Border = "FREE";
+
+	// generations waiting to be painted; the generating thread never draws anything itself,
+	// it publishes its changes here and the interface paints them whenever it gets to it
+	FrameRing m_Frames;
+	FrameRing::Frame m_Frame;
+	std::atomic<bool> m_FramesScheduled{ false };
+
+	// generations since the last published frame and the cells they changed (each of them once),
+	// so only every k-th generation has to be painted
+	std::vector<Change> m_Publish;
+	std::vector<char> m_PublishMark;
+	int m_PublishGenerations = 0;
+	int m_PublishCount = 0;
+
+	// with a target speed, k follows from how long a step and a paint take (in seconds)
+	static constexpr double FRAME_INTERVAL = 1.0 / 60;
+	std::atomic<int> m_RenderEvery{ 1 };
+	std::atomic<double> m_PaintCost{ 0 };
+	double m_StepCost = 0;
+	std::chrono::steady_clock::time_point m_PaceDeadline;
+
+	// generations painted since m_SpeedStart, for the speed shown next to the delay
+	long long m_SpeedGenerations = 0;
+	std::chrono::steady_clock::time_point m_SpeedStart;
+
+	// visible cells and their colors, copied out of the universe and the palette before a redraw
+	// (the generating thread changes both under m_MutexCells)
+	std::vector<StateId> m_VisibleCells;
+	std::vector<wxColour> m_VisibleColors;
+
+	// what every rule cost, see GetProfiler()
+	RuleProfiler m_Profiler;
 
 	wxTimer* m_TimerSelection = nullptr;
 
@@ -168,17 +272,24 @@ private:
 	void OnScroll(wxScrollWinEvent& evt);
 	void OnSize(wxSizeEvent& evt);
 
-	void DeleteStructure(int X, int Y, std::string state = "");
-	void DrawStructure(int X, int Y, std::string state, wxColour color);
-	void DrawLine(int x, int y, std::string state, wxColour color, bool remove = false);
+	void DeleteStructure(int X, int Y, StateId state = STATE_INVALID);
+	void DrawStructure(int X, int Y, StateId state);
+	void DrawLine(int x, int y, StateId state, bool remove = false);
 	bool InBounds(int x, int y);
 	bool InVisibleBounds(int x, int y);
 
-	std::pair<std::vector<std::pair<int, int>>, std::string> ParseRule(std::pair<std::string, Transition>& rule, std::unordered_set<int>& visited);
-	std::pair<std::vector<std::pair<std::string, std::pair<int, int>>>, std::string> ParseAllRules();
-	bool ApplyOnCell(int x, int y, Transition& rule, std::unordered_set<std::string>& neighbors);
-	std::unordered_map<std::string, std::string> GetNeighborhood(std::pair<int, int> xy, std::unordered_set<std::string>& neighbors);
-	void UpdateGeneration(std::vector<std::pair<std::string, std::pair<int, int>>> changes);
+	// gives back the ids of the states that aren't listed anymore and aren't on the grid
+	void ReleaseStates(const std::vector<std::string>& states);
+
+	std::string ParseAllRules();
+
+	void ClearHistory();
+	int UpdateHistory();
+	void UpdateGeneration(std::vector<Change>& changes);
+	void PublishGeneration();
+	void FlushGenerations();
+	void PaceGeneration();
+	void PaintFrames();
 
 	void UpdateCoordsHovered();
 };
\ No newline at end of file
@@ -0,0 +1,467 @@
+#include "HashLife.h"
+
+#include <algorithm>
+
+HashLife::HashLife()
+{
+}
+
+HashLife::~HashLife()
+{
+}
+
+bool HashLife::Prepare(const std::vector<std::pair<std::string, Transition>>& rules, RuleCompiler& compiler, Universe& cells)
+{
+	// every state with rules has to be in a lookup table, so the rules only depend on the 3x3 neighborhood
+	if (!compiler.IsUnbounded(rules)) return false;
+
+	m_Identity = false;
+	for (auto& rule : rules)
+	{
+		if (rule.second.fromId == rule.second.stateId) m_Identity = true;
+	}
+
+	m_Compiler = &compiler;
+
+	// results depend on the rules
+	if (compiler.GetKey() != m_Key)
+	{
+		m_Key = compiler.GetKey();
+		ClearResults();
+	}
+
+	// plane is out of date (or a step was never written back)
+	if (!m_Loaded || m_Pending || cells.GetVersion() != m_Version) Load(cells);
+
+	return true;
+}
+
+bool HashLife::Step(int step)
+{
+	m_Step = step;
+
+	// leave room for everything the cells can reach in 2^step generations
+	while (m_Nodes[m_Root].level < step + 2 || m_Nodes[GetCenter(m_Root)].population != m_Nodes[m_Root].population) Expand();
+	Expand();
+
+	int root = m_Root;
+	int level = m_Nodes[root].level;
+
+	int next = GetResult(root);
+	bool changed = m_Identity || next != GetCenter(root);
+
+	// same cells after 2^step generations might still be an oscillator -> check the next generation
+	if (!changed && step > 0)
+	{
+		m_Step = 0;
+		changed = GetResult(root) != GetCenter(root);
+		m_Step = step;
+	}
+
+	m_Root = next;
+	m_X += 1LL << (level - 2);
+	m_Y += 1LL << (level - 2);
+
+	Shrink();
+
+	if (m_Nodes.size() * NODE_BYTES > m_MemoryCap) Collect();
+
+	m_Pending = true;
+
+	return changed;
+}
+
+void HashLife::GetChanges(Universe& cells, std::vector<Change>& changes)
+{
+	// cells of the plane that aren't "FREE"
+	GetChanges(m_Root, m_X, m_Y, cells, changes);
+
+	// cells of the universe that became "FREE"
+	const int cols = cells.GetCols();
+
+	for (StateId state = 1; state < cells.GetStateCount(); state++)
+	{
+		for (int k : cells.GetPositions(state))
+		{
+			if (GetCell(k % cols, k / cols) == STATE_FREE) changes.push_back({ k, state, STATE_FREE });
+		}
+	}
+}
+
+void HashLife::Commit(Universe& cells)
+{
+	if (!m_Pending) return;
+
+	m_Version = cells.GetVersion();
+	m_Pending = false;
+}
+
+void HashLife::SetMemoryCap(size_t bytes)
+{
+	m_MemoryCap = bytes;
+}
+
+size_t HashLife::GetNodeCount()
+{
+	return m_Nodes.size();
+}
+
+double HashLife::GetHitRate()
+{
+	if (m_Hits + m_Misses == 0) return 0.0;
+
+	return (double)m_Hits / (m_Hits + m_Misses);
+}
+
+long long HashLife::GetPopulation()
+{
+	if (m_Root == -1) return 0;
+
+	return m_Nodes[m_Root].population;
+}
+
+void HashLife::Reset()
+{
+	m_Nodes.clear();
+	m_Table.clear();
+	m_Leaves.clear();
+	m_Empty.clear();
+
+	m_Root = -1;
+	m_Hits = 0;
+	m_Misses = 0;
+}
+
+void HashLife::Load(Universe& cells)
+{
+	Reset();
+
+	// smallest square covering the universe
+	int level = LEVEL_MIN;
+	while ((1LL << level) < std::max(cells.GetRows(), cells.GetCols())) level++;
+
+	m_Root = Build(cells, level, 0, 0);
+	m_X = 0;
+	m_Y = 0;
+
+	m_Version = cells.GetVersion();
+	m_Loaded = true;
+	m_Pending = false;
+}
+
+int HashLife::Build(Universe& cells, int level, long long x, long long y)
+{
+	if (x >= cells.GetCols() || y >= cells.GetRows()) return GetEmpty(level);
+
+	if (level == 0) return GetLeaf(cells.Get(x, y));
+
+	long long half = 1LL << (level - 1);
+
+	return Join(
+		Build(cells, level - 1, x, y), Build(cells, level - 1, x + half, y),
+		Build(cells, level - 1, x, y + half), Build(cells, level - 1, x + half, y + half)
+	);
+}
+
+int HashLife::GetLeaf(StateId state)
+{
+	if (state >= m_Leaves.size()) m_Leaves.resize(state + 1, -1);
+
+	if (m_Leaves[state] == -1)
+	{
+		Node node;
+		node.state = state;
+		node.population = state != STATE_FREE;
+
+		m_Leaves[state] = m_Nodes.size();
+		m_Nodes.push_back(node);
+	}
+
+	return m_Leaves[state];
+}
+
+int HashLife::GetEmpty(int level)
+{
+	if (level >= m_Empty.size()) m_Empty.resize(level + 1, -1);
+
+	if (m_Empty[level] == -1)
+	{
+		if (level == 0) m_Empty[level] = GetLeaf(STATE_FREE);
+		else
+		{
+			int empty = GetEmpty(level - 1);
+			m_Empty[level] = Join(empty, empty, empty, empty);
+		}
+	}
+
+	return m_Empty[level];
+}
+
+int HashLife::Join(int nw, int ne, int sw, int se)
+{
+	// same children -> same node
+	NodeKey key = { nw, ne, sw, se };
+
+	auto it = m_Table.find(key);
+	if (it != m_Table.end()) return it->second;
+
+	Node node;
+	node.nw = nw;
+	node.ne = ne;
+	node.sw = sw;
+	node.se = se;
+	node.level = m_Nodes[nw].level + 1;
+	node.population = m_Nodes[nw].population + m_Nodes[ne].population + m_Nodes[sw].population + m_Nodes[se].population;
+
+	int index = m_Nodes.size();
+	m_Nodes.push_back(node);
+	m_Table[key] = index;
+
+	return index;
+}
+
+int HashLife::GetCenter(int node)
+{
+	// half as big, same center
+	Node n = m_Nodes[node];
+
+	return Join(m_Nodes[n.nw].se, m_Nodes[n.ne].sw, m_Nodes[n.sw].ne, m_Nodes[n.se].nw);
+}
+
+int HashLife::GetResult(int node)
+{
+	int level = m_Nodes[node].level;
+
+	// results of another step size aren't of any use
+	int step = std::min(level - 2, m_Step);
+	if (m_Nodes[node].result != -1 && m_Nodes[node].resultStep == step)
+	{
+		m_Hits++;
+		return m_Nodes[node].result;
+	}
+
+	m_Misses++;
+
+	int result = -1;
+
+	if (level == 2) result = GetBase(node);
+	else
+	{
+		// copies, since m_Nodes grows below
+		Node n = m_Nodes[node];
+		Node nw = m_Nodes[n.nw];
+		Node ne = m_Nodes[n.ne];
+		Node sw = m_Nodes[n.sw];
+		Node se = m_Nodes[n.se];
+
+		// 9 overlapping nodes a quarter as big as this one
+		int n00 = n.nw;
+		int n01 = Join(nw.ne, ne.nw, nw.se, ne.sw);
+		int n02 = n.ne;
+		int n10 = Join(nw.sw, nw.se, sw.nw, sw.ne);
+		int n11 = Join(nw.se, ne.sw, sw.ne, se.nw);
+		int n12 = Join(ne.sw, ne.se, se.nw, se.ne);
+		int n20 = n.sw;
+		int n21 = Join(sw.ne, se.nw, sw.se, se.sw);
+		int n22 = n.se;
+
+		int r[3][3] = { { n00, n01, n02 }, { n10, n11, n12 }, { n20, n21, n22 } };
+
+		// full speed: both halves of the time step are results;
+		// otherwise the first half only takes the centers and doesn't advance
+		bool fast = level - 2 <= m_Step;
+		for (int i = 0; i < 3; i++)
+		{
+			for (int j = 0; j < 3; j++) r[i][j] = fast ? GetResult(r[i][j]) : GetCenter(r[i][j]);
+		}
+
+		result = Join(
+			GetResult(Join(r[0][0], r[0][1], r[1][0], r[1][1])),
+			GetResult(Join(r[0][1], r[0][2], r[1][1], r[1][2])),
+			GetResult(Join(r[1][0], r[1][1], r[2][0], r[2][1])),
+			GetResult(Join(r[1][1], r[1][2], r[2][1], r[2][2]))
+		);
+	}
+
+	m_Nodes[node].result = result;
+	m_Nodes[node].resultStep = step;
+
+	return result;
+}
+
+int HashLife::GetBase(int node)
+{
+	// 4x4 cells -> the 2x2 cells in the middle, one generation later
+	StateId grid[4][4];
+
+	Node n = m_Nodes[node];
+	int quadrants[4] = { n.nw, n.ne, n.sw, n.se };
+
+	for (int q = 0; q < 4; q++)
+	{
+		Node child = m_Nodes[quadrants[q]];
+		int children[4] = { child.nw, child.ne, child.sw, child.se };
+
+		for (int c = 0; c < 4; c++)
+		{
+			int x = (q % 2) * 2 + c % 2;
+			int y = (q / 2) * 2 + c / 2;
+
+			grid[y][x] = m_Nodes[children[c]].state;
+		}
+	}
+
+	return Join(
+		GetLeaf(GetNext(grid, 1, 1)), GetLeaf(GetNext(grid, 2, 1)),
+		GetLeaf(GetNext(grid, 1, 2)), GetLeaf(GetNext(grid, 2, 2))
+	);
+}
+
+StateId HashLife::GetNext(StateId grid[4][4], int x, int y)
+{
+	StateId neighborhood[N_DIRECTIONS];
+	for (int d = 0; d < N_DIRECTIONS; d++) neighborhood[d] = grid[y + DIRECTION_DY[d]][x + DIRECTION_DX[d]];
+
+	return m_Compiler->GetNext(grid[y][x], neighborhood);
+}
+
+StateId HashLife::GetCell(long long x, long long y)
+{
+	int node = m_Root;
+	long long size = 1LL << m_Nodes[node].level;
+
+	x -= m_X;
+	y -= m_Y;
+
+	if (x < 0 || y < 0 || x >= size || y >= size) return STATE_FREE;
+
+	while (m_Nodes[node].level > 0)
+	{
+		if (m_Nodes[node].population == 0) return STATE_FREE;
+
+		size /= 2;
+
+		Node& n = m_Nodes[node];
+		if (y < size) node = x < size ? n.nw : n.ne;
+		else node = x < size ? n.sw : n.se;
+
+		if (x >= size) x -= size;
+		if (y >= size) y -= size;
+	}
+
+	return m_Nodes[node].state;
+}
+
+void HashLife::Expand()
+{
+	// same cells with an empty border around them, twice as big
+	Node n = m_Nodes[m_Root];
+	int empty = GetEmpty(n.level - 1);
+
+	m_Root = Join(
+		Join(empty, empty, empty, n.nw), Join(empty, empty, n.ne, empty),
+		Join(empty, n.sw, empty, empty), Join(n.se, empty, empty, empty)
+	);
+
+	m_X -= 1LL << (n.level - 1);
+	m_Y -= 1LL << (n.level - 1);
+}
+
+void HashLife::Shrink()
+{
+	// drop empty borders, so the tree doesn't keep growing
+	while (m_Nodes[m_Root].level > LEVEL_MIN)
+	{
+		int center = GetCenter(m_Root);
+		if (m_Nodes[center].population != m_Nodes[m_Root].population) break;
+
+		m_X += 1LL << (m_Nodes[m_Root].level - 2);
+		m_Y += 1LL << (m_Nodes[m_Root].level - 2);
+		m_Root = center;
+	}
+}
+
+void HashLife::Collect()
+{
+	// keep only the nodes of the current plane, results are computed again when needed
+	std::vector<Node> nodes;
+	std::vector<int> copies(m_Nodes.size(), -1);
+
+	m_Table.clear();
+	m_Leaves.clear();
+	m_Empty.clear();
+
+	m_Root = Copy(m_Root, nodes, copies);
+	m_Nodes.swap(nodes);
+
+	for (int i = 0; i < m_Nodes.size(); i++)
+	{
+		Node& node = m_Nodes[i];
+
+		if (node.level == 0)
+		{
+			if (node.state >= m_Leaves.size()) m_Leaves.resize(node.state + 1, -1);
+			m_Leaves[node.state] = i;
+		}
+		else m_Table[{ node.nw, node.ne, node.sw, node.se }] = i;
+	}
+}
+
+int HashLife::Copy(int node, std::vector<Node>& nodes, std::vector<int>& copies)
+{
+	if (copies[node] != -1) return copies[node];
+
+	Node copy = m_Nodes[node];
+	copy.result = -1;
+	copy.resultStep = -1;
+
+	if (copy.level > 0)
+	{
+		copy.nw = Copy(copy.nw, nodes, copies);
+		copy.ne = Copy(copy.ne, nodes, copies);
+		copy.sw = Copy(copy.sw, nodes, copies);
+		copy.se = Copy(copy.se, nodes, copies);
+	}
+
+	copies[node] = nodes.size();
+	nodes.push_back(copy);
+
+	return copies[node];
+}
+
+void HashLife::ClearResults()
+{
+	for (auto& node : m_Nodes)
+	{
+		node.result = -1;
+		node.resultStep = -1;
+	}
+
+	m_Hits = 0;
+	m_Misses = 0;
+}
+
+void HashLife::GetChanges(int node, long long x, long long y, Universe& cells, std::vector<Change>& changes)
+{
+	Node n = m_Nodes[node];
+	long long size = 1LL << n.level;
+
+	// nothing here, or outside of the universe
+	if (n.population == 0) return;
+	if (x >= cells.GetCols() || y >= cells.GetRows() || x + size <= 0 || y + size <= 0) return;
+
+	if (n.level == 0)
+	{
+		int k = y * cells.GetCols() + x;
+		if (cells.Get(k) != n.state) changes.push_back({ k, cells.Get(k), n.state });
+
+		return;
+	}
+
+	long long half = size / 2;
+
+	GetChanges(n.nw, x, y, cells, changes);
+	GetChanges(n.ne, x + half, y, cells, changes);
+	GetChanges(n.sw, x, y + half, cells, changes);
+	GetChanges(n.se, x + half, y + half, cells, changes);
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include "Transition.h"
+#include "StateRegistry.h"
+#include "Universe.h"
+#include "RuleCompiler.h"
+
+// quadtree of canonical nodes with memoized results, advancing 2^step generations at once
+// on an unbounded plane; the universe only shows the part of the plane it covers
+class HashLife
+{
+public:
+	HashLife();
+	~HashLife();
+
+	// can the (compiled) rules be applied on the plane? keeps the plane in sync with the cells
+	bool Prepare(const std::vector<std::pair<std::string, Transition>>& rules, RuleCompiler& compiler, Universe& cells);
+
+	// false if the plane is still the same afterwards
+	bool Step(int step);
+
+	// cells of the universe that aren't the same as on the plane (from = current state, to = state on the plane)
+	void GetChanges(Universe& cells, std::vector<Change>& changes);
+
+	// the changes of the last step have been written back into the cells
+	void Commit(Universe& cells);
+
+	// the node table is collected whenever it grows past this
+	void SetMemoryCap(size_t bytes);
+
+	size_t GetNodeCount();
+	double GetHitRate();
+	long long GetPopulation();
+private:
+	struct Node
+	{
+		int nw = -1;
+		int ne = -1;
+		int sw = -1;
+		int se = -1;
+		int level = 0;
+		StateId state = STATE_FREE;
+
+		// center of the node, 2^(level - 2) generations later (or 2^step if that's less)
+		int result = -1;
+		int resultStep = -1;
+
+		// cells which aren't "FREE"
+		long long population = 0;
+	};
+
+	struct NodeKey
+	{
+		int nw, ne, sw, se;
+
+		inline bool operator==(const NodeKey& other) const
+		{
+			return nw == other.nw && ne == other.ne && sw == other.sw && se == other.se;
+		}
+	};
+
+	struct NodeHash
+	{
+		inline size_t operator() (const NodeKey& key) const
+		{
+			size_t hash = key.nw;
+			hash = hash * 1000003 + key.ne;
+			hash = hash * 1000003 + key.sw;
+			hash = hash * 1000003 + key.se;
+
+			return hash;
+		}
+	};
+
+	// rough size of a node, table entry included
+	static const int NODE_BYTES = sizeof(Node) + sizeof(NodeKey) + 32;
+	static const int LEVEL_MIN = 3;
+
+	RuleCompiler* m_Compiler = nullptr;
+	std::string m_Key;
+
+	// rules that keep the state of a cell apply forever, even if nothing changes
+	bool m_Identity = false;
+
+	std::vector<Node> m_Nodes;
+	std::unordered_map<NodeKey, int, NodeHash> m_Table;
+	std::vector<int> m_Leaves;
+	std::vector<int> m_Empty;
+
+	// top left corner of the root on the plane
+	int m_Root = -1;
+	long long m_X = 0;
+	long long m_Y = 0;
+
+	int m_Step = -1;
+	size_t m_MemoryCap = 512 << 20;
+	long long m_Hits = 0;
+	long long m_Misses = 0;
+
+	// version of the cells the plane was copied from
+	unsigned long long m_Version = 0;
+	bool m_Loaded = false;
+	bool m_Pending = false;
+
+	void Reset();
+	void Load(Universe& cells);
+	int Build(Universe& cells, int level, long long x, long long y);
+
+	int GetLeaf(StateId state);
+	int GetEmpty(int level);
+	int Join(int nw, int ne, int sw, int se);
+	int GetCenter(int node);
+	int GetResult(int node);
+	int GetBase(int node);
+	StateId GetNext(StateId grid[4][4], int x, int y);
+	StateId GetCell(long long x, long long y);
+
+	void Expand();
+	void Shrink();
+	void Collect();
+	int Copy(int node, std::vector<Node>& nodes, std::vector<int>& copies);
+	void ClearResults();
+
+	void GetChanges(int node, long long x, long long y, Universe& cells, std::vector<Change>& changes);
+};
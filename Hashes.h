@@ -13,8 +13,17 @@ private:
 public:
 	struct PairInt {
 		inline size_t operator() (const pair<int, int>& p) const {
-			// return the 1d index of a 2d point
-			return p.second * Sizes::N_COLS + p.first;
+			// mix both coordinates, points aren't limited to the size of the grid
+			return hash<unsigned long long>()(((unsigned long long)(unsigned int)p.second << 32) | (unsigned int)p.first);
+		}
+	};
+
+	struct PairLongLong {
+		inline size_t operator() (const pair<long long, long long>& p) const {
+			unsigned long long h = (unsigned long long)p.first * 0x9E3779B97F4A7C15ULL;
+			h ^= (unsigned long long)p.second + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+
+			return h;
 		}
 	};
 };
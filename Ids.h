@@ -47,6 +47,8 @@ public:
 		ID_SEARCH_RULES,
 		ID_GOTO_RULE,
 		ID_DELETE_RULE,
+		ID_COMPILED_RULES,
+		ID_PROFILE_RULES,
 
 		// ToolZoom
 		ID_ZOOM_OUT, ID_ZOOM_IN,
@@ -54,6 +54,9 @@ void InputNeighbors::SetNeighbors(std::vector<std::string> neighbors)
 			m_Buttons[neighbors[i]]->SetValue(1);
 		}
 	}
+
+	// the grid isn't there yet when the default neighbors are set
+	if (m_Grid) m_Grid->UpdateRuleSet();
 }
 
 void InputNeighbors::BuildInterface()
@@ -142,4 +145,8 @@ void InputNeighbors::OnToggleButton(wxCommandEvent& evt)
 		// neighbor not in list -> add it
 		m_Neighbors.insert(neighbor);
 	}
+
+	// rules counting a direction that's no longer a neighbor can't run anymore
+	std::string error = m_Grid->UpdateRuleSet();
+	if (error.size()) wxMessageBox("Some of the rules can't run with this neighborhood.\n" + error, "Warning", wxICON_WARNING);
 }
@@ -1,5 +1,9 @@
 #include "InputRules.h"
 #include "Interpreter.h"
+#include "RuleCompiler.h"
+#include "DialogProfiler.h"
+
+#include "wx/richmsgdlg.h"
 
 #include <unordered_set>
 
@@ -50,7 +54,7 @@ void InputRules::SetInputNeighbors(InputNeighbors* inputNeighbors)
     m_InputNeighbors = inputNeighbors;
 }
 
-void InputRules::SetRules(std::vector<std::pair<std::string, Transition>> rules)
+std::string InputRules::SetRules(std::vector<std::pair<std::string, Transition>> rules)
 {
     m_Rules = rules;
 
@@ -126,6 +130,9 @@ void InputRules::SetRules(std::vector<std::pair<std::string, Transition>> rules)
     }
 
     m_List->RefreshAfterUpdate();
+
+    // checked and resolved once, instead of at every generation
+    return m_InputStates->GetGrid()->UpdateRuleSet();
 }
 
 void InputRules::UpdateColor(std::string state, wxColour color)
@@ -281,6 +288,9 @@ void InputRules::BuildMenu()
     m_Menu->Append(Ids::ID_GOTO_RULE, "Go To");
     m_Menu->AppendSeparator();
     m_Menu->Append(Ids::ID_DELETE_RULE, "Delete");
+    m_Menu->AppendSeparator();
+    m_Menu->Append(Ids::ID_COMPILED_RULES, "Compiled Rules");
+    m_Menu->Append(Ids::ID_PROFILE_RULES, "Rule Profile");
 
     m_Menu->Bind(wxEVT_COMMAND_MENU_SELECTED, &InputRules::OnMenuSelected, this);
 }
@@ -314,6 +324,12 @@ void InputRules::OnMenuSelected(wxCommandEvent& evt)
     case Ids::ID_DELETE_RULE:
         RuleDelete();
         break;
+    case Ids::ID_COMPILED_RULES:
+        RuleReport();
+        break;
+    case Ids::ID_PROFILE_RULES:
+        RuleProfile();
+        break;
     default:
         break;
     }
@@ -385,6 +401,50 @@ void InputRules::RuleDelete()
     SetRules(interpreter.GetTransitions());
 }
 
+void InputRules::RuleReport()
+{
+    // compile the rules the grid runs to see which of them get a lookup table
+    std::shared_ptr<const RuleSet> ruleSet = m_InputStates->GetGrid()->GetRuleSet();
+    const std::vector<std::pair<std::string, Transition>>& rules = ruleSet->GetRules();
+
+    RuleCompiler compiler;
+    compiler.Compile(rules);
+
+    std::vector<std::pair<bool, std::string>>& report = compiler.GetReport();
+
+    int compiled = 0;
+    std::string details = "";
+    for (int i = 0; i < rules.size(); i++)
+    {
+        std::string rule = rules[i].first + "/" + rules[i].second.state;
+        if (!rules[i].second.condition.empty()) rule += ":" + rules[i].second.condition;
+
+        details += "Rule number " + std::to_string(i + 1) + " (" + rule + "): ";
+
+        if (report[i].first)
+        {
+            compiled++;
+            details += "compiled\n";
+        }
+        else details += "not compiled, " + report[i].second + "\n";
+    }
+
+    wxRichMessageDialog dialog(
+        this, wxString::Format("%i out of %i rules are applied through lookup tables.", compiled, (int)rules.size()), "Compiled Rules",
+        wxOK | wxICON_INFORMATION
+    );
+    dialog.ShowDetailedText(details);
+
+    dialog.ShowModal();
+}
+
+void InputRules::RuleProfile()
+{
+    DialogProfiler dialog(this, m_InputStates->GetGrid()->GetProfiler());
+
+    dialog.ShowModal();
+}
+
 void InputRules::OnEdit(wxCommandEvent& evt)
 {
     m_List->SetFocus();
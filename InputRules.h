@@ -29,7 +29,8 @@ public:
 	void SetInputStates(InputStates* inputStates);
 	void SetInputNeighbors(InputNeighbors* inputNeighbors);
 
-	void SetRules(std::vector<std::pair<std::string, Transition>> rules);
+	// "" if the rules can run with the states and the neighbors, otherwise what's wrong (see Grid::UpdateRuleSet)
+	std::string SetRules(std::vector<std::pair<std::string, Transition>> rules);
 	void UpdateColor(std::string state, wxColour color);
 private:
 	ListRules* m_List = nullptr;
@@ -54,6 +55,8 @@ private:
 
 	void RuleGoTo();
 	void RuleDelete();
+	void RuleReport();
+	void RuleProfile();
 
 	void OnEdit(wxCommandEvent& evt);
 	void FocusSearch(wxCommandEvent& evt);
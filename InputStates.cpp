@@ -29,7 +29,7 @@ std::unordered_map<std::string, std::string>& InputStates::GetStates()
 	return m_States;
 }
 
-void InputStates::SetStates(std::vector<std::string> states)
+std::string InputStates::SetStates(std::vector<std::string> states)
 {
     // states appear in our map but not in the given list -> they got recently deleted
     for (auto it = m_States.begin(); it != m_States.end();)
@@ -132,6 +132,9 @@ void InputStates::SetStates(std::vector<std::string> states)
     for (auto& it : states) statesColors.push_back({ it, wxColour(m_States[it]) });
 
     m_ToolStates->SetStates(statesColors);
+
+    // the rules are checked against the new states right away
+    return m_Grid->UpdateRuleSet();
 }
 
 void InputStates::SetToolStates(ToolStates* toolStates)
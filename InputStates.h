@@ -25,7 +25,8 @@ public:
 	ListStates* GetList();
 	std::unordered_map<std::string, std::string>& GetStates();
 
-	void SetStates(std::vector<std::string> states);
+	// "" if the rules can run with the states, otherwise what's wrong (see Grid::UpdateRuleSet)
+	std::string SetStates(std::vector<std::string> states);
 	void SetToolStates(ToolStates* toolModes);
 	void SetGrid(Grid* grid);
 	void SetEditorStates(EditorStates* editorStates);
@@ -2,7 +2,7 @@
 #include "Sizes.h"
 
 #include <sstream>
-#include "wx/log.h"
+#include <algorithm>
 
 Interpreter::Interpreter()
 {
@@ -202,6 +202,7 @@ vector<pair<int, string>> Interpreter::Process(string& rules)
 							{
 								// could indicate either a group of directions or a specific one
 								string neighborhood;
+								Shape shape;
 								ss >> neighborhood; FindWord(cursor, rules, neighborhood); SkipIfComment(cursor, rules, ss, neighborhood);
 								transition.condition += neighborhood;
 
@@ -227,18 +228,19 @@ vector<pair<int, string>> Interpreter::Process(string& rules)
 
 										if (valid)
 										{
-											if (find(neighbors.begin(), neighbors.end(), direction) != neighbors.end()) 
-												MarkInvalid(valid, invalid, direction, "<DUPLICATE NEIGHBOR>", cursor);
+											// "N" and "N1" are the same neighbor
+											int dx, dy;
+											GetOffset(direction, dx, dy);
 
-											if (valid)
+											for (auto& neighbor : neighbors)
 											{
-												neighbors.push_back(direction);
+												int ndx, ndy;
+												GetOffset(neighbor, ndx, ndy);
 
-												if (transition.directions.find(direction) == transition.directions.end())
-												{
-													transition.directions.insert(direction);
-												}
+												if (ndx == dx && ndy == dy) MarkInvalid(valid, invalid, direction, "<DUPLICATE NEIGHBOR>", cursor);
 											}
+
+											if (valid) neighbors.push_back(direction);
 										}
 
 										if (!valid) break;
@@ -262,6 +264,22 @@ vector<pair<int, string>> Interpreter::Process(string& rules)
 											// assign to transition
 											if (valid) transition.andRules.back().first = neighbors;
 
+											// directions past the 9 of the neighbors panel make it a shape of its own
+											bool large = false;
+											for (auto& neighbor : neighbors)
+											{
+												if (GetDirectionIndex(neighbor) == -1) large = true;
+											}
+
+											if (large) transition.all = true;
+											else for (auto& neighbor : neighbors)
+											{
+												if (transition.directions.find(neighbor) == transition.directions.end())
+												{
+													transition.directions.insert(neighbor);
+												}
+											}
+
 											break;
 										}
 										// invalid symbol
@@ -272,13 +290,15 @@ vector<pair<int, string>> Interpreter::Process(string& rules)
 										}
 									}
 								}
-								// a specific direction or "ALL" meaning every possible valid direction
-								else if (valid && (neighborhood == "ALL" || CheckDirection(neighborhood)))
+								// a specific direction, "ALL" meaning every possible valid direction or a large neighborhood, eg. "MOORE5"
+								else if (valid && (neighborhood == "ALL" || CheckDirection(neighborhood) || GetShape(neighborhood, shape)))
 								{
 									// assign to transition
 									transition.andRules.back().first = { neighborhood };
 
-									if (neighborhood != "ALL" && transition.directions.find(neighborhood) == transition.directions.end())
+									// cells far from any cell of the condition states are counted too, so every cell is looked at
+									if (neighborhood != "ALL" && GetDirectionIndex(neighborhood) == -1) transition.all = true;
+									else if (neighborhood != "ALL" && transition.directions.find(neighborhood) == transition.directions.end())
 									{
 										transition.directions.insert(neighborhood);
 									}
@@ -577,7 +597,10 @@ bool Interpreter::CheckDirection(string& direction)
 		}
 	);
 
-	return directions.find(direction) != directions.end();
+	// steps further away, eg. "N2E1"
+	int dx, dy;
+
+	return directions.find(direction) != directions.end() || GetOffset(direction, dx, dy);
 }
 
 int Interpreter::CheckNumber(string& number, Transition& transition, int& count)
@@ -0,0 +1,53 @@
+#include "Mailbox.h"
+
+Mailbox::Mailbox()
+{
+}
+
+Mailbox::~Mailbox()
+{
+	Empty();
+}
+
+void Mailbox::Resize(int senders)
+{
+	Empty();
+
+	m_Senders = senders;
+	m_Slots.reset(new atomic<vector<Migrant>*>[senders]);
+
+	for (int i = 0; i < senders; i++) m_Slots[i] = nullptr;
+}
+
+void Mailbox::Send(int sender, vector<Migrant>* migrants)
+{
+	// the receiver didn't get to the last batch yet -> it's too old to be of any use
+	vector<Migrant>* old = m_Slots[sender].exchange(migrants);
+
+	delete old;
+}
+
+vector<Mailbox::Migrant> Mailbox::Receive()
+{
+	vector<Migrant> migrants;
+
+	for (int i = 0; i < m_Senders; i++)
+	{
+		vector<Migrant>* batch = m_Slots[i].exchange(nullptr);
+		if (!batch) continue;
+
+		for (auto& migrant : *batch) migrants.push_back(move(migrant));
+
+		delete batch;
+	}
+
+	return migrants;
+}
+
+void Mailbox::Empty()
+{
+	// moved to another mailbox
+	if (!m_Slots) return;
+
+	for (int i = 0; i < m_Senders; i++) delete m_Slots[i].exchange(nullptr);
+}
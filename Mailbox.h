@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+#include "Chromosome.h"
+
+// chromosomes sent to an island of the GA by the other islands, without any locks: every sender
+// has a slot of its own, and a new batch takes the place of the one still waiting in it (if any)
+class Mailbox
+{
+public:
+	struct Migrant
+	{
+		// with the results it had on its island
+		Chromosome chromosome;
+		vector<uint8_t> genes;
+	};
+
+	Mailbox();
+	~Mailbox();
+
+	// one slot for every island that might send something; only before the islands start
+	void Resize(int senders);
+
+	void Send(int sender, vector<Migrant>* migrants);
+
+	// everything sent since the last call, only by the island owning the mailbox
+	vector<Migrant> Receive();
+private:
+	int m_Senders = 0;
+	unique_ptr<atomic<vector<Migrant>*>[]> m_Slots;
+
+	void Empty();
+};
@@ -0,0 +1,209 @@
+#include "NeighborCounts.h"
+
+#include <unordered_map>
+#include <algorithm>
+
+NeighborCounts::NeighborCounts()
+{
+}
+
+NeighborCounts::~NeighborCounts()
+{
+}
+
+bool NeighborCounts::Prepare(const std::vector<std::pair<std::string, Transition>>& rules, RuleCompiler& compiler, Universe& cells)
+{
+	m_Prepared = false;
+
+	// conditions of every neighborhood, only for the rules applied cell by cell
+	std::unordered_map<int, int> conditions;
+	for (auto& rule : rules)
+	{
+		if (compiler.IsCompiled(rule.second.fromId)) continue;
+
+		for (int i = 0; i < rule.second.idRules.size(); i++)
+		{
+			for (int j = 0; j < rule.second.idRules[i].size(); j++)
+			{
+				// large neighborhoods are counted by ShapeCounts
+				if (rule.second.idShapes[i][j].type != SHAPE_NONE) continue;
+
+				for (auto& conditionsOr : rule.second.idRules[i][j].second) conditions[rule.second.idMasks[i][j]] += conditionsOr.size();
+			}
+		}
+	}
+
+	int mask = -1;
+	int most = 0;
+	for (auto& it : conditions)
+	{
+		if (it.second > most || (it.second == most && it.first < mask))
+		{
+			mask = it.first;
+			most = it.second;
+		}
+	}
+
+	// states of the conditions of that neighborhood
+	std::vector<StateId> counted;
+	for (auto& rule : rules)
+	{
+		if (mask == -1) break;
+		if (compiler.IsCompiled(rule.second.fromId)) continue;
+
+		for (int i = 0; i < rule.second.idRules.size(); i++)
+		{
+			for (int j = 0; j < rule.second.idRules[i].size(); j++)
+			{
+				if (rule.second.idMasks[i][j] != mask || rule.second.idShapes[i][j].type != SHAPE_NONE) continue;
+
+				for (auto& conditionsOr : rule.second.idRules[i][j].second)
+				{
+					for (auto& conditionsAnd : conditionsOr)
+					{
+						StateId state = conditionsAnd.second;
+
+						if (state == STATE_INVALID || counted.size() == COUNTED_MAX) continue;
+						if (std::find(counted.begin(), counted.end(), state) == counted.end()) counted.push_back(state);
+					}
+				}
+			}
+		}
+	}
+	std::sort(counted.begin(), counted.end());
+
+	if (counted.empty())
+	{
+		m_Mask = -1;
+		m_Loaded = false;
+
+		return false;
+	}
+
+	// something else to count than last time
+	if (mask != m_Mask || counted != m_Counted)
+	{
+		m_Mask = mask;
+		m_Counted = counted;
+		m_Loaded = false;
+
+		m_Directions.clear();
+		for (int d = 0; d < N_DIRECTIONS; d++)
+		{
+			if (mask & (1 << d)) m_Directions.push_back(d);
+		}
+
+		m_Slots.assign(*std::max_element(counted.begin(), counted.end()) + 1, -1);
+		for (int i = 0; i < counted.size(); i++) m_Slots[counted[i]] = i;
+		m_nCounted = counted.size();
+	}
+
+	// cells were edited since the last generation
+	if (!m_Loaded || cells.GetVersion() != m_Version || cells.GetRows() != m_Rows || cells.GetCols() != m_Cols) Load(cells);
+
+	m_Prepared = true;
+
+	return true;
+}
+
+void NeighborCounts::Update(std::vector<Change>& changes, Universe& cells)
+{
+	if (!m_Prepared) return;
+
+	m_Prepared = false;
+
+	// cells past the edges are ghosts of the cells on them, unless there's nothing or a fixed border
+	bool wraps = cells.GetTopology() != TOPOLOGY_BOUNDED && cells.GetTopology() != TOPOLOGY_BORDER;
+	std::vector<int> recount;
+
+	// the cells which see the changed cell in one of the counted directions
+	for (auto& change : changes)
+	{
+		int from = GetSlot(change.from);
+		int to = GetSlot(change.to);
+
+		if (from == to) continue;
+
+		int x = change.cell % m_Cols;
+		int y = change.cell / m_Cols;
+
+		// the cells around one on the edge can see it from more than one direction,
+		// so they're counted again once all the other changes are in
+		if (wraps && (x == 0 || y == 0 || x == m_Cols - 1 || y == m_Rows - 1))
+		{
+			for (int d = 0; d < N_DIRECTIONS; d++) recount.push_back(cells.Map(x + DIRECTION_DX[d], y + DIRECTION_DY[d]));
+			continue;
+		}
+
+		for (int d : m_Directions)
+		{
+			int nx = x - DIRECTION_DX[d];
+			int ny = y - DIRECTION_DY[d];
+
+			if (nx < 0 || ny < 0 || nx >= m_Cols || ny >= m_Rows) continue;
+
+			int k = (ny * m_Cols + nx) * m_nCounted;
+
+			if (from != -1) m_Counts[k + from]--;
+			if (to != -1) m_Counts[k + to]++;
+		}
+	}
+
+	for (int i : recount)
+	{
+		int x = i % m_Cols;
+		int y = i / m_Cols;
+		int k = i * m_nCounted;
+
+		std::fill(m_Counts.begin() + k, m_Counts.begin() + k + m_nCounted, 0);
+
+		for (int d : m_Directions)
+		{
+			int slot = GetSlot(cells.GetWrapped(x + DIRECTION_DX[d], y + DIRECTION_DY[d]));
+			if (slot != -1) m_Counts[k + slot]++;
+		}
+	}
+
+	m_Version = cells.GetVersion();
+}
+
+void NeighborCounts::Clear()
+{
+	m_Mask = -1;
+	m_Counted.clear();
+	m_Counts.clear();
+	m_Loaded = false;
+	m_Prepared = false;
+}
+
+void NeighborCounts::Load(Universe& cells)
+{
+	m_Rows = cells.GetRows();
+	m_Cols = cells.GetCols();
+
+	m_Counts.assign((size_t)m_Rows * m_Cols * m_nCounted, 0);
+
+	// the ghosts stand for whatever is past the edges
+	cells.RefreshGhosts();
+
+	const StateId* padded = cells.GetPadded();
+	const int P = cells.GetPaddedCols();
+
+	for (int y = 0; y < m_Rows; y++)
+	{
+		for (int x = 0; x < m_Cols; x++)
+		{
+			int k = (y * m_Cols + x) * m_nCounted;
+			int p = (y + 1) * P + x + 1;
+
+			for (int d : m_Directions)
+			{
+				int slot = GetSlot(padded[p + DIRECTION_DY[d] * P + DIRECTION_DX[d]]);
+				if (slot != -1) m_Counts[k + slot]++;
+			}
+		}
+	}
+
+	m_Version = cells.GetVersion();
+	m_Loaded = true;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "Transition.h"
+#include "StateRegistry.h"
+#include "Universe.h"
+#include "RuleCompiler.h"
+
+// for every cell, how many of its neighbors are of each state counted by the conditions;
+// kept up to date with the changes of every generation, so a condition is a single read
+// instead of a look at every direction (only for the neighborhood most conditions count)
+class NeighborCounts
+{
+public:
+	// at most this many states get counted, every one of them costs a byte per cell
+	static const int COUNTED_MAX = 16;
+
+	NeighborCounts();
+	~NeighborCounts();
+
+	// anything for the rules which aren't compiled to count? the counts are rebuilt if the cells
+	// were edited (or a generation went by without Update)
+	bool Prepare(const std::vector<std::pair<std::string, Transition>>& rules, RuleCompiler& compiler, Universe& cells);
+
+	// are the directions (see Transition::idMasks) the ones being counted?
+	inline bool Covers(int mask) const { return mask == m_Mask; }
+
+	// -1 if the state isn't counted
+	inline int GetSlot(StateId state) const { return state < m_Slots.size() ? m_Slots[state] : -1; }
+	inline int Get(int k, int slot) const { return m_Counts[k * m_nCounted + slot]; }
+
+	// the changes of the prepared generation are now in the cells
+	void Update(std::vector<Change>& changes, Universe& cells);
+
+	void Clear();
+private:
+	// -1 = nothing is counted
+	int m_Mask = -1;
+	std::vector<int> m_Directions;
+
+	std::vector<StateId> m_Counted;
+	std::vector<int> m_Slots;
+	int m_nCounted = 0;
+
+	// m_Counts[k * m_nCounted + slot]
+	std::vector<uint8_t> m_Counts;
+	int m_Rows = 0;
+	int m_Cols = 0;
+
+	// version of the cells the counts were taken from
+	unsigned long long m_Version = 0;
+	bool m_Loaded = false;
+	bool m_Prepared = false;
+
+	void Load(Universe& cells);
+};
@@ -0,0 +1,176 @@
+#include "PatternFile.h"
+
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+std::pair<PatternFile::Pattern, std::vector<std::pair<int, std::string>>> PatternFile::Read(const std::string& text)
+{
+	Pattern pattern;
+	std::vector<std::pair<int, std::string>> errors;
+
+	// text of every section, without its marker
+	std::unordered_set<std::string> marks = { "[STATES]", "[RULES]", "[NEIGHBORS]", "[SIZE]", "[CELLS]" };
+	std::vector<std::pair<std::string, std::string>> sections;
+	int cellsLine = 0;
+
+	std::istringstream stream(text);
+	std::string line;
+
+	for (int i = 1; std::getline(stream, line); i++)
+	{
+		if (line.size() && line.back() == '\r') line.pop_back();
+
+		std::string mark = line;
+		while (mark.size() && mark.back() == ' ') mark.pop_back();
+
+		if (marks.find(mark) != marks.end())
+		{
+			sections.push_back({ mark, "" });
+			if (mark == "[CELLS]") cellsLine = i;
+
+			continue;
+		}
+
+		if (sections.size()) sections.back().second += line + "\n";
+	}
+
+	if (sections.empty() || sections.front().first != "[STATES]")
+	{
+		errors.push_back({ 0, "Line marker \"[STATES]\" not found" });
+		return { pattern, errors };
+	}
+
+	for (auto& section : sections)
+	{
+		if (section.first == "[STATES]")
+		{
+			std::istringstream states(section.second);
+			std::string state;
+
+			while (std::getline(states, state, ';'))
+			{
+				// comments go until the end of the line
+				while (state.find('!') != state.npos)
+				{
+					size_t begin = state.find('!');
+					size_t end = state.find('\n', begin);
+
+					state.erase(begin, end == state.npos ? state.npos : end - begin);
+				}
+
+				std::istringstream name(state);
+				std::string s;
+
+				if (name >> s) pattern.states.push_back(s);
+			}
+		}
+		else if (section.first == "[RULES]") pattern.rules = section.second;
+		else if (section.first == "[NEIGHBORS]")
+		{
+			std::istringstream neighbors(section.second);
+			std::string neighbor;
+
+			while (neighbors >> neighbor) pattern.neighbors.insert(neighbor);
+		}
+		else if (section.first == "[SIZE]")
+		{
+			std::istringstream size(section.second);
+
+			if (!(size >> pattern.rows >> pattern.cols) || pattern.rows <= 0 || pattern.cols <= 0)
+			{
+				errors.push_back({ 0, "Invalid size" });
+			}
+
+			// the edges are bounded unless told otherwise
+			std::string topology;
+			if (size >> topology)
+			{
+				std::transform(topology.begin(), topology.end(), topology.begin(), ::toupper);
+				pattern.topology = GetTopologyIndex(topology);
+
+				if (pattern.topology == -1)
+				{
+					pattern.topology = TOPOLOGY_BOUNDED;
+					errors.push_back({ 0, "Invalid topology " + topology });
+				}
+				else if (pattern.topology == TOPOLOGY_BORDER && !(size >> pattern.border))
+				{
+					errors.push_back({ 0, "Missing border state" });
+				}
+			}
+		}
+		else if (section.first == "[CELLS]")
+		{
+			auto cells = ReadCells(section.second);
+
+			pattern.cells = cells.first;
+			for (auto& error : cells.second) errors.push_back({ cellsLine + error.first, error.second });
+		}
+	}
+
+	return { pattern, errors };
+}
+
+std::pair<std::vector<std::pair<std::pair<long long, long long>, std::string>>, std::vector<std::pair<int, std::string>>> PatternFile::ReadCells(const std::string& text)
+{
+	std::vector<std::pair<std::pair<long long, long long>, std::string>> cells;
+	std::vector<std::pair<int, std::string>> errors;
+
+	std::istringstream stream(text);
+	std::string line;
+
+	for (int i = 1; std::getline(stream, line); i++)
+	{
+		if (line.size() && line.back() == '\r') line.pop_back();
+		if (line.empty()) continue;
+
+		if (line.back() != ';')
+		{
+			errors.push_back({ i, "Missing ';'" });
+			continue;
+		}
+		line.pop_back();
+
+		std::istringstream fields(line);
+		std::string x, y, state, rest;
+		fields >> x >> y >> state >> rest;
+
+		if (state.empty() || rest.size())
+		{
+			errors.push_back({ i, "Expected '<x> <y> <state>;'" });
+			continue;
+		}
+
+		// coordinates past 64 bits are as invalid as the ones that aren't numbers
+		try
+		{
+			size_t endX = 0;
+			size_t endY = 0;
+			long long cx = std::stoll(x, &endX);
+			long long cy = std::stoll(y, &endY);
+
+			if (endX != x.size() || endY != y.size()) throw std::invalid_argument(line);
+
+			cells.push_back({ { cx, cy }, state });
+		}
+		catch (...)
+		{
+			errors.push_back({ i, "Invalid coordinates" });
+		}
+	}
+
+	return { cells, errors };
+}
+
+std::string PatternFile::WriteCells(const std::vector<std::pair<std::pair<long long, long long>, std::string>>& cells)
+{
+	std::string text;
+
+	for (auto& cell : cells)
+	{
+		text += std::to_string(cell.first.first) + " " + std::to_string(cell.first.second) + " " + cell.second + ";\r\n";
+	}
+
+	return text;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include <unordered_set>
+
+#include "Topology.h"
+
+// pattern files are made of "[STATES]", "[RULES]", "[NEIGHBORS]", "[SIZE]" and "[CELLS]";
+// the coordinates of the cells are relative to the center of the grid and don't
+// have to fit inside of it, so they're read and written as 64-bit integers
+class PatternFile
+{
+private:
+	PatternFile() {};
+	~PatternFile() {};
+public:
+	struct Pattern
+	{
+		std::vector<std::string> states;
+		std::string rules;
+		std::unordered_set<std::string> neighbors;
+		int rows = 0;
+		int cols = 0;
+
+		// "<rows> <cols> [<topology> [<border state>]]", see Topology.h
+		int topology = TOPOLOGY_BOUNDED;
+		std::string border = "FREE";
+		std::vector<std::pair<std::pair<long long, long long>, std::string>> cells;
+	};
+
+	// every section of the file; the rules are left as text for the interpreter
+	static std::pair<Pattern, std::vector<std::pair<int, std::string>>> Read(const std::string& text);
+
+	// pair = (((<x>, <y>), <state>)s, (<line>, <error>)s), one "<x> <y> <state>;" per line
+	static std::pair<std::vector<std::pair<std::pair<long long, long long>, std::string>>, std::vector<std::pair<int, std::string>>> ReadCells(const std::string& text);
+	static std::string WriteCells(const std::vector<std::pair<std::pair<long long, long long>, std::string>>& cells);
+};
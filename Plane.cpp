@@ -0,0 +1,293 @@
+#include "Plane.h"
+
+#include <algorithm>
+
+Plane::Plane()
+{
+}
+
+Plane::~Plane()
+{
+}
+
+StateId Plane::Get(long long x, long long y) const
+{
+	auto it = m_Chunks.find({ x >> CHUNK_BITS, y >> CHUNK_BITS });
+	if (it == m_Chunks.end()) return STATE_FREE;
+
+	return it->second.cells[(y & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (x & (CHUNK_SIZE - 1))];
+}
+
+void Plane::Set(long long x, long long y, StateId state)
+{
+	std::pair<long long, long long> key = { x >> CHUNK_BITS, y >> CHUNK_BITS };
+
+	auto it = m_Chunks.find(key);
+	if (it == m_Chunks.end())
+	{
+		// "FREE" cells don't need a chunk
+		if (state == STATE_FREE) return;
+
+		it = m_Chunks.insert({ key, Chunk() }).first;
+		it->second.cells.assign(CHUNK_SIZE * CHUNK_SIZE, STATE_FREE);
+	}
+
+	Chunk& chunk = it->second;
+	StateId& cell = chunk.cells[(y & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (x & (CHUNK_SIZE - 1))];
+	if (cell == state) return;
+
+	if (cell == STATE_FREE)
+	{
+		chunk.population++;
+		m_Population++;
+	}
+	else if (state == STATE_FREE)
+	{
+		chunk.population--;
+		m_Population--;
+	}
+
+	cell = state;
+
+	if (chunk.population == 0) m_Chunks.erase(it);
+}
+
+void Plane::Clear()
+{
+	m_Chunks.clear();
+	m_Population = 0;
+	m_Loaded = false;
+	m_Pending = false;
+}
+
+long long Plane::GetPopulation() const
+{
+	return m_Population;
+}
+
+size_t Plane::GetChunkCount() const
+{
+	return m_Chunks.size();
+}
+
+std::vector<std::pair<std::pair<long long, long long>, StateId>> Plane::GetCells() const
+{
+	std::vector<std::pair<std::pair<long long, long long>, StateId>> cells;
+	cells.reserve(m_Population);
+
+	for (auto& it : m_Chunks)
+	{
+		long long x0 = it.first.first * CHUNK_SIZE;
+		long long y0 = it.first.second * CHUNK_SIZE;
+
+		for (int k = 0; k < CHUNK_SIZE * CHUNK_SIZE; k++)
+		{
+			StateId state = it.second.cells[k];
+			if (state != STATE_FREE) cells.push_back({ { x0 + k % CHUNK_SIZE, y0 + k / CHUNK_SIZE }, state });
+		}
+	}
+
+	return cells;
+}
+
+bool Plane::Prepare(const std::vector<std::pair<std::string, Transition>>& rules, RuleCompiler& compiler, Universe& cells)
+{
+	// empty chunks have to stay empty, otherwise the plane would fill up everywhere
+	if (!compiler.IsUnbounded(rules)) return false;
+
+	m_Identity = false;
+	for (auto& rule : rules)
+	{
+		if (rule.second.fromId == rule.second.stateId) m_Identity = true;
+	}
+
+	Sync(cells);
+
+	return true;
+}
+
+void Plane::Sync(Universe& cells)
+{
+	// cells were edited (or a step was never written back)
+	if (!m_Loaded || m_Pending || cells.GetVersion() != m_Version) Load(cells);
+}
+
+bool Plane::Step(RuleCompiler& compiler, ThreadPool& pool)
+{
+	// chunks with cells and the chunks around them, nothing else can change
+	std::unordered_map<std::pair<long long, long long>, char, Hashes::PairLongLong> targets;
+	for (auto& it : m_Chunks)
+	{
+		for (int d = 0; d < N_DIRECTIONS; d++)
+		{
+			targets[{ it.first.first + DIRECTION_DX[d], it.first.second + DIRECTION_DY[d] }] = 1;
+		}
+	}
+
+	std::vector<std::pair<long long, long long>> keys;
+	keys.reserve(targets.size());
+	for (auto& it : targets) keys.push_back(it.first);
+
+	std::vector<Chunk> next(keys.size());
+	std::vector<char> changed(keys.size(), 0);
+
+	pool.For(keys.size(), std::bind(&Plane::StepChunk, this, std::placeholders::_1, std::ref(compiler), std::ref(keys), std::ref(next), std::ref(changed)));
+
+	bool any = m_Identity;
+	for (int i = 0; i < keys.size(); i++)
+	{
+		if (!changed[i]) continue;
+
+		any = true;
+
+		auto it = m_Chunks.find(keys[i]);
+		if (it != m_Chunks.end())
+		{
+			m_Population -= it->second.population;
+
+			if (next[i].population == 0)
+			{
+				m_Chunks.erase(it);
+				continue;
+			}
+
+			m_Population += next[i].population;
+			it->second = std::move(next[i]);
+		}
+		else if (next[i].population)
+		{
+			m_Population += next[i].population;
+			m_Chunks.insert({ keys[i], std::move(next[i]) });
+		}
+	}
+
+	m_Pending = true;
+
+	return any;
+}
+
+void Plane::StepChunk(
+	int i, RuleCompiler& compiler,
+	std::vector<std::pair<long long, long long>>& keys,
+	std::vector<Chunk>& next, std::vector<char>& changed
+)
+{
+	const int PADDED = CHUNK_SIZE + 2;
+
+	long long cx = keys[i].first;
+	long long cy = keys[i].second;
+
+	// the chunk with a border of one cell taken from the chunks around it
+	std::vector<StateId> grid(PADDED * PADDED, STATE_FREE);
+	const Chunk* center = nullptr;
+
+	for (int dy = -1; dy <= 1; dy++)
+	{
+		for (int dx = -1; dx <= 1; dx++)
+		{
+			auto it = m_Chunks.find({ cx + dx, cy + dy });
+			if (it == m_Chunks.end()) continue;
+
+			const Chunk& chunk = it->second;
+			if (dx == 0 && dy == 0) center = &chunk;
+
+			int yBegin = dy == -1 ? CHUNK_SIZE - 1 : 0;
+			int yEnd = dy == 1 ? 1 : CHUNK_SIZE;
+			int xBegin = dx == -1 ? CHUNK_SIZE - 1 : 0;
+			int xEnd = dx == 1 ? 1 : CHUNK_SIZE;
+
+			for (int y = yBegin; y < yEnd; y++)
+			{
+				for (int x = xBegin; x < xEnd; x++)
+				{
+					grid[(y + 1 + dy * CHUNK_SIZE) * PADDED + x + 1 + dx * CHUNK_SIZE] = chunk.cells[y * CHUNK_SIZE + x];
+				}
+			}
+		}
+	}
+
+	Chunk& result = next[i];
+	result.cells.assign(CHUNK_SIZE * CHUNK_SIZE, STATE_FREE);
+
+	StateId neighborhood[N_DIRECTIONS];
+	for (int y = 0; y < CHUNK_SIZE; y++)
+	{
+		for (int x = 0; x < CHUNK_SIZE; x++)
+		{
+			for (int d = 0; d < N_DIRECTIONS; d++)
+			{
+				neighborhood[d] = grid[(y + 1 + DIRECTION_DY[d]) * PADDED + x + 1 + DIRECTION_DX[d]];
+			}
+
+			StateId state = compiler.GetNext(neighborhood[4], neighborhood);
+			result.cells[y * CHUNK_SIZE + x] = state;
+
+			if (state != STATE_FREE) result.population++;
+		}
+	}
+
+	if (center) changed[i] = result.cells != center->cells;
+	else changed[i] = result.population != 0;
+}
+
+void Plane::GetChanges(Universe& cells, std::vector<Change>& changes)
+{
+	const int rows = cells.GetRows();
+	const int cols = cells.GetCols();
+
+	// cells of the plane that aren't "FREE"
+	for (auto& it : m_Chunks)
+	{
+		long long x0 = it.first.first * CHUNK_SIZE;
+		long long y0 = it.first.second * CHUNK_SIZE;
+
+		if (x0 >= cols || y0 >= rows || x0 + CHUNK_SIZE <= 0 || y0 + CHUNK_SIZE <= 0) continue;
+
+		int xBegin = std::max(0LL, x0);
+		int xEnd = std::min<long long>(cols, x0 + CHUNK_SIZE);
+		int yBegin = std::max(0LL, y0);
+		int yEnd = std::min<long long>(rows, y0 + CHUNK_SIZE);
+
+		for (int y = yBegin; y < yEnd; y++)
+		{
+			for (int x = xBegin; x < xEnd; x++)
+			{
+				StateId state = it.second.cells[(y - y0) * CHUNK_SIZE + x - x0];
+				if (state == STATE_FREE) continue;
+
+				int k = y * cols + x;
+				if (cells.Get(k) != state) changes.push_back({ k, cells.Get(k), state });
+			}
+		}
+	}
+
+	// cells of the universe that became "FREE"
+	for (StateId state = 1; state < cells.GetStateCount(); state++)
+	{
+		for (int k : cells.GetPositions(state))
+		{
+			if (Get(k % cols, k / cols) == STATE_FREE) changes.push_back({ k, state, STATE_FREE });
+		}
+	}
+}
+
+void Plane::Commit(Universe& cells)
+{
+	if (!m_Pending) return;
+
+	m_Version = cells.GetVersion();
+	m_Pending = false;
+}
+
+void Plane::Load(Universe& cells)
+{
+	// the window is overwritten, everything outside of it stays
+	for (int y = 0; y < cells.GetRows(); y++)
+	{
+		for (int x = 0; x < cells.GetCols(); x++) Set(x, y, cells.Get(x, y));
+	}
+
+	m_Version = cells.GetVersion();
+	m_Loaded = true;
+	m_Pending = false;
+}
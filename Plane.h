@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <string>
+#include <utility>
+
+#include "Transition.h"
+#include "StateRegistry.h"
+#include "Universe.h"
+#include "RuleCompiler.h"
+#include "ThreadPool.h"
+#include "Hashes.h"
+
+// cells on a plane without any edges, kept in chunks of CHUNK_SIZE x CHUNK_SIZE cells;
+// chunks only exist while they have cells which aren't "FREE"
+class Plane
+{
+public:
+	static const int CHUNK_BITS = 6;
+	static const int CHUNK_SIZE = 1 << CHUNK_BITS;
+
+	Plane();
+	~Plane();
+
+	StateId Get(long long x, long long y) const;
+	void Set(long long x, long long y, StateId state);
+	void Clear();
+
+	long long GetPopulation() const;
+	size_t GetChunkCount() const;
+
+	// pair = ((<x>, <y>), <state>) for every cell which isn't "FREE"
+	std::vector<std::pair<std::pair<long long, long long>, StateId>> GetCells() const;
+
+	// can the (compiled) rules be applied on the plane? the universe is the part of the plane between
+	// (0, 0) and (cols - 1, rows - 1), its cells are copied in if they were edited since the last sync
+	bool Prepare(const std::vector<std::pair<std::string, Transition>>& rules, RuleCompiler& compiler, Universe& cells);
+
+	// only copies the cells of the universe in, if needed
+	void Sync(Universe& cells);
+
+	// next generation of the whole plane; false if nothing changed
+	bool Step(RuleCompiler& compiler, ThreadPool& pool);
+
+	// cells of the universe that aren't the same as on the plane (from = current state, to = state on the plane)
+	void GetChanges(Universe& cells, std::vector<Change>& changes);
+
+	// the universe has the same cells as the plane now
+	void Commit(Universe& cells);
+private:
+	struct Chunk
+	{
+		std::vector<StateId> cells;
+		int population = 0;
+	};
+
+	std::unordered_map<std::pair<long long, long long>, Chunk, Hashes::PairLongLong> m_Chunks;
+	long long m_Population = 0;
+
+	// rules that keep the state of a cell apply forever, even if nothing changes
+	bool m_Identity = false;
+
+	// version of the cells the plane was synced with
+	unsigned long long m_Version = 0;
+	bool m_Loaded = false;
+	bool m_Pending = false;
+
+	void Load(Universe& cells);
+
+	void StepChunk(
+		int i, RuleCompiler& compiler,
+		std::vector<std::pair<long long, long long>>& keys,
+		std::vector<Chunk>& next, std::vector<char>& changed
+	);
+};
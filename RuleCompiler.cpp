@@ -0,0 +1,467 @@
+#include "RuleCompiler.h"
+
+#include <algorithm>
+
+RuleCompiler::RuleCompiler()
+{
+}
+
+RuleCompiler::~RuleCompiler()
+{
+}
+
+bool RuleCompiler::Compile(const std::vector<std::pair<std::string, Transition>>& rules)
+{
+	// same rules as last time -> keep the tables
+	std::string signature = GetSignature(rules);
+	if (signature == m_Key) return false;
+
+	m_Key = signature;
+
+	m_Report.assign(rules.size(), { false, "" });
+	m_Compiled.clear();
+	m_Directions.clear();
+	m_Counted.clear();
+	m_Weights.clear();
+	m_Tables.clear();
+
+	// every id used by the rules needs a slot
+	int nStates = 0;
+	for (auto& rule : rules)
+	{
+		nStates = std::max(nStates, rule.second.fromId + 1);
+		nStates = std::max(nStates, rule.second.stateId + 1);
+		for (auto& state : rule.second.stateIds) nStates = std::max(nStates, state + 1);
+	}
+
+	m_Compiled.assign(nStates, false);
+	m_Directions.assign(nStates, {});
+	m_Counted.assign(nStates, {});
+	m_Weights.assign(nStates, {});
+	m_Tables.assign(nStates, {});
+
+	// rules of the same state are applied in order -> group them
+	std::vector<std::vector<int>> groups(nStates);
+	for (int i = 0; i < rules.size(); i++)
+	{
+		if (rules[i].second.fromId == STATE_INVALID || rules[i].second.stateId == STATE_INVALID)
+		{
+			m_Report[i] = { false, "rule hasn't been resolved" };
+			continue;
+		}
+
+		groups[rules[i].second.fromId].push_back(i);
+	}
+
+	for (StateId from = 0; from < nStates; from++)
+	{
+		std::vector<int>& group = groups[from];
+		if (group.empty()) continue;
+
+		// -1 marks a neighborhood that hasn't been seen yet
+		std::vector<int> directions = { -1 };
+		int failed = -1;
+
+		for (int i : group)
+		{
+			std::string reason = CheckRule(rules[i].second, directions);
+
+			m_Report[i] = { reason.empty(), reason };
+			if (reason.size() && failed == -1) failed = i;
+		}
+
+		if (directions.size() && directions[0] == -1) directions.clear();
+
+		// states whose counts index the table
+		std::vector<StateId> counted;
+		for (int i : group)
+		{
+			for (auto& state : rules[i].second.stateIds)
+			{
+				if (std::find(counted.begin(), counted.end(), state) == counted.end()) counted.push_back(state);
+			}
+		}
+
+		const int base = directions.size() + 1;
+		long long size = 1;
+		for (int i = 0; i < counted.size() && size <= TABLE_MAX; i++) size *= base;
+
+		if (failed == -1 && size > TABLE_MAX)
+		{
+			for (int i : group) m_Report[i] = { false, "too many condition states for a lookup table" };
+			continue;
+		}
+
+		// one rule of this state can't be compiled -> none of them can
+		if (failed != -1)
+		{
+			for (int i : group)
+			{
+				if (m_Report[i].first) m_Report[i] = { false, "shares its first state with rule number " + std::to_string(failed + 1) };
+			}
+
+			continue;
+		}
+
+		std::vector<int> weights(nStates, 0);
+		int weight = 1;
+		for (auto& state : counted)
+		{
+			weights[state] = weight;
+			weight *= base;
+		}
+
+		// first rule that applies for every possible combination of counts
+		std::vector<StateId> table(size, STATE_INVALID);
+		std::vector<int> counts(nStates, 0);
+
+		for (int key = 0; key < size; key++)
+		{
+			int rest = key;
+			for (auto& state : counted)
+			{
+				counts[state] = rest % base;
+				rest /= base;
+			}
+
+			for (int i : group)
+			{
+				if (Evaluate(rules[i].second, counts))
+				{
+					table[key] = rules[i].second.stateId;
+					break;
+				}
+			}
+		}
+
+		m_Compiled[from] = true;
+		m_Directions[from] = directions;
+		m_Counted[from] = counted;
+		m_Weights[from] = weights;
+		m_Tables[from] = table;
+	}
+
+	return true;
+}
+
+bool RuleCompiler::IsCompiled(StateId state)
+{
+	return state < m_Compiled.size() && m_Compiled[state];
+}
+
+const std::string& RuleCompiler::GetKey()
+{
+	// rules the tables were built from
+	return m_Key;
+}
+
+std::vector<int>& RuleCompiler::GetDirections(StateId state)
+{
+	return m_Directions[state];
+}
+
+std::vector<StateId>& RuleCompiler::GetCounted(StateId state)
+{
+	return m_Counted[state];
+}
+
+StateId RuleCompiler::Lookup(StateId state, std::vector<int>& counts)
+{
+	// counts are indexed by state id
+	int key = 0;
+	for (auto& s : m_Counted[state])
+	{
+		if (s < counts.size()) key += m_Weights[state][s] * counts[s];
+	}
+
+	return m_Tables[state][key];
+}
+
+StateId RuleCompiler::GetNext(StateId state, StateId neighborhood[N_DIRECTIONS])
+{
+	// states without rules never change
+	if (!IsCompiled(state)) return state;
+
+	std::vector<int>& weights = m_Weights[state];
+
+	int key = 0;
+	for (int d : m_Directions[state])
+	{
+		if (neighborhood[d] < weights.size()) key += weights[neighborhood[d]];
+	}
+
+	StateId next = m_Tables[state][key];
+	if (next == STATE_INVALID) return state;
+
+	return next;
+}
+
+bool RuleCompiler::IsUnbounded(const std::vector<std::pair<std::string, Transition>>& rules)
+{
+	for (auto& rule : rules)
+	{
+		if (!IsCompiled(rule.second.fromId)) return false;
+	}
+
+	if (!IsCompiled(STATE_FREE)) return true;
+
+	// every counted direction is "FREE"
+	int key = m_Weights[STATE_FREE][STATE_FREE] * m_Directions[STATE_FREE].size();
+	StateId next = m_Tables[STATE_FREE][key];
+
+	return next == STATE_INVALID || next == STATE_FREE;
+}
+
+void RuleCompiler::Apply(StateId state, Universe& cells, std::vector<char>& visited, std::vector<std::pair<int, StateId>>& applied, int band)
+{
+	if (!IsCompiled(state)) return;
+
+	const int rows = cells.GetRows();
+	const int cols = cells.GetCols();
+	const StateId* grid = cells.GetCells();
+
+	std::vector<int>& directions = m_Directions[state];
+	std::vector<StateId>& counted = m_Counted[state];
+
+	// only the cells of these rows are evaluated
+	int rowBegin = 0;
+	int rowEnd = rows;
+	if (band != -1)
+	{
+		rowBegin = band * cells.GetBandRows();
+		rowEnd = std::min(rows, rowBegin + cells.GetBandRows());
+	}
+
+	// cells without any condition state around them might change as well
+	// -> iterate through all cells of this state
+	bool all = m_Tables[state][0] != STATE_INVALID;
+
+	// otherwise decide if it's faster to iterate through all cells
+	// or through the condition states' neighbors
+	int n1 = cells.CountState(state);
+	int n2 = 0;
+	for (auto& s : counted)
+	{
+		// cells next to a border can't be found through the cells of the universe
+		if (s == STATE_FREE || cells.IsBorder(s)) all = true;
+		n2 += cells.CountState(s);
+	}
+
+	if (all || n1 <= n2)
+	{
+		if (state == STATE_FREE)
+		{
+			for (int k = rowBegin * cols; k < rowEnd * cols; k++)
+			{
+				if (grid[k] == STATE_FREE) ApplyOnCell(state, k, cells, visited, applied);
+			}
+		}
+		else if (band == -1)
+		{
+			for (int k : cells.GetPositions(state)) ApplyOnCell(state, k, cells, visited, applied);
+		}
+		else
+		{
+			for (int k : cells.GetBand(state, band)) ApplyOnCell(state, k, cells, visited, applied);
+		}
+
+		return;
+	}
+
+	// past the edges of a klein bottle or a mirror, a cell can be seen from other directions than its own
+	std::vector<int> around = directions;
+	if (cells.GetTopology() == TOPOLOGY_KLEIN || cells.GetTopology() == TOPOLOGY_MIRROR)
+	{
+		around.clear();
+		for (int d = 0; d < N_DIRECTIONS; d++) around.push_back(d);
+	}
+
+	for (auto& s : counted)
+	{
+		// neighbors of the cells in this band might be in the bands next to it (or across the edges)
+		std::vector<const std::vector<int>*> lists;
+		if (band == -1) lists.push_back(&cells.GetPositions(s));
+		else for (int b : cells.GetBandsAround(band)) lists.push_back(&cells.GetBand(s, b));
+
+		for (auto& positions : lists)
+		{
+			for (int i : *positions)
+			{
+				int x = i % cols;
+				int y = i / cols;
+
+				// cells that have this one in their neighborhood
+				for (int d : around)
+				{
+					int k = cells.Map(x - DIRECTION_DX[d], y - DIRECTION_DY[d]);
+					if (k == -1 || k / cols < rowBegin || k / cols >= rowEnd) continue;
+
+					if (grid[k] == state) ApplyOnCell(state, k, cells, visited, applied);
+				}
+			}
+		}
+	}
+}
+
+void RuleCompiler::Apply(StateId state, Universe& cells, std::vector<int>& candidates, std::vector<char>& visited, std::vector<std::pair<int, StateId>>& applied)
+{
+	if (!IsCompiled(state)) return;
+
+	const StateId* grid = cells.GetCells();
+
+	for (int k : candidates)
+	{
+		if (grid[k] == state) ApplyOnCell(state, k, cells, visited, applied);
+	}
+}
+
+std::vector<std::pair<bool, std::string>>& RuleCompiler::GetReport()
+{
+	return m_Report;
+}
+
+std::string RuleCompiler::GetSignature(const std::vector<std::pair<std::string, Transition>>& rules)
+{
+	std::string signature = "";
+
+	for (auto& rule : rules)
+	{
+		signature += std::to_string(rule.second.fromId) + "/" + std::to_string(rule.second.stateId) + ":" + rule.second.condition;
+
+		// "@ALL" depends on the neighborhood and the names on the registry
+		for (auto& rulesAnd : rule.second.idRules)
+		{
+			for (auto& it : rulesAnd)
+			{
+				signature += "[";
+				for (int d : it.first) signature += std::to_string(d);
+				signature += "]";
+
+				for (auto& conditionsOr : it.second)
+				{
+					for (auto& conditionsAnd : conditionsOr) signature += "#" + std::to_string(conditionsAnd.second);
+				}
+			}
+		}
+
+		signature += ";";
+	}
+
+	return signature;
+}
+
+std::string RuleCompiler::CheckRule(const Transition& rule, std::vector<int>& directions)
+{
+	// a table for every possible count of cells that far away would never end
+	if (rule.large) return "counts cells of a large neighborhood";
+
+	for (auto& rulesAnd : rule.idRules)
+	{
+		for (auto& it : rulesAnd)
+		{
+			std::vector<int> neighborhood = it.first;
+			std::sort(neighborhood.begin(), neighborhood.end());
+
+			if (directions.size() && directions[0] == -1) directions = neighborhood;
+			else if (directions != neighborhood) return "counts cells of different neighborhoods";
+		}
+	}
+
+	// rules that could apply without any condition state around are
+	// always evaluated on every cell, so the table has to agree with that
+	bool full = rule.all || rule.condition.empty();
+	for (auto& state : rule.stateIds)
+	{
+		if (state == rule.fromId) full = true;
+	}
+
+	std::vector<int> counts(std::max<int>(rule.fromId, rule.stateId) + 1, 0);
+	for (auto& state : rule.stateIds) counts.resize(std::max<int>(counts.size(), state + 1), 0);
+
+	if (!full && Evaluate(rule, counts)) return "applies without any condition state around";
+
+	return "";
+}
+
+bool RuleCompiler::Evaluate(const Transition& rule, std::vector<int>& counts)
+{
+	// same as applying the rule on a cell, but with the counts already known
+	bool ruleValid = true;
+	// iterate through the chain of "OR" rules
+	for (auto& rulesOr : rule.idRules)
+	{
+		ruleValid = true;
+
+		// iterate through the chain of "AND" rules
+		for (auto& rulesAnd : rulesOr)
+		{
+			bool conditionValid = true;
+			// iterate through the chain of "OR" conditions
+			for (auto& conditionsOr : rulesAnd.second)
+			{
+				conditionValid = true;
+
+				// iterate through the chain of "AND" conditions
+				for (auto& conditionsAnd : conditionsOr)
+				{
+					int occurences = counts[conditionsAnd.second];
+
+					int conditionNumber = conditionsAnd.first.first;
+					int conditionType = conditionsAnd.first.second;
+
+					switch (conditionType)
+					{
+					case TYPE_EQUAL:
+						if (occurences != conditionNumber) conditionValid = false;
+						break;
+					case TYPE_LESS:
+						if (occurences >= conditionNumber) conditionValid = false;
+						break;
+					case TYPE_MORE:
+						if (occurences <= conditionNumber) conditionValid = false;
+						break;
+					default:
+						break;
+					}
+				}
+
+				if (conditionValid) break;
+			}
+
+			if (!conditionValid)
+			{
+				ruleValid = false;
+				break;
+			}
+		}
+
+		if (ruleValid) break;
+	}
+
+	return ruleValid;
+}
+
+void RuleCompiler::ApplyOnCell(StateId state, int k, Universe& cells, std::vector<char>& visited, std::vector<std::pair<int, StateId>>& applied)
+{
+	// every rule of this state is in the table, so a cell only needs to be looked up once
+	if (visited[k]) return;
+	visited[k] = true;
+
+	const int cols = cells.GetCols();
+	const int P = cells.GetPaddedCols();
+	const StateId* padded = cells.GetPadded();
+	std::vector<int>& weights = m_Weights[state];
+
+	// the ghosts stand for whatever is past the edges (out of bounds cells aren't counted)
+	const int p = (k / cols + 1) * P + k % cols + 1;
+
+	int key = 0;
+	for (int d : m_Directions[state])
+	{
+		StateId neighbor = padded[p + DIRECTION_DY[d] * P + DIRECTION_DX[d]];
+		if (neighbor < weights.size()) key += weights[neighbor];
+	}
+
+	StateId next = m_Tables[state][key];
+	if (next != STATE_INVALID) applied.push_back({ k, next });
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <unordered_set>
+
+#include "Transition.h"
+#include "StateRegistry.h"
+#include "Universe.h"
+
+// turns the rules of a state into a lookup table indexed by the number of
+// neighbors of every condition state, when all of them count the same directions
+class RuleCompiler
+{
+public:
+	RuleCompiler();
+	~RuleCompiler();
+
+	// rules need to be resolved before compiling them
+	bool Compile(const std::vector<std::pair<std::string, Transition>>& rules);
+	bool IsCompiled(StateId state);
+	const std::string& GetKey();
+	std::vector<int>& GetDirections(StateId state);
+	std::vector<StateId>& GetCounted(StateId state);
+	StateId Lookup(StateId state, std::vector<int>& counts);
+
+	// next state of a cell, given the states in every direction
+	StateId GetNext(StateId state, StateId neighborhood[N_DIRECTIONS]);
+
+	// every rule is in a table and "FREE" stays "FREE" around nothing,
+	// so the rules can run on a plane without any edges
+	bool IsUnbounded(const std::vector<std::pair<std::string, Transition>>& rules);
+
+	// band = -1 for the whole universe, otherwise only the cells in that band of rows (see Universe::BuildBands);
+	// neighbors are read from the ghosts, which have to be refreshed before (see Universe::RefreshGhosts)
+	void Apply(StateId state, Universe& cells, std::vector<char>& visited, std::vector<std::pair<int, StateId>>& applied, int band = -1);
+
+	// only the given cells (of this state) are evaluated
+	void Apply(StateId state, Universe& cells, std::vector<int>& candidates, std::vector<char>& visited, std::vector<std::pair<int, StateId>>& applied);
+
+	// pair = (<compiled>, <reason why it wasn't>) for every rule
+	std::vector<std::pair<bool, std::string>>& GetReport();
+private:
+	static const int TABLE_MAX = 1 << 16;
+
+	std::string m_Key;
+	std::vector<std::pair<bool, std::string>> m_Report;
+
+	// everything below is indexed by the first state of the rules
+	std::vector<char> m_Compiled;
+	std::vector<std::vector<int>> m_Directions;
+	std::vector<std::vector<StateId>> m_Counted;
+	std::vector<std::vector<int>> m_Weights;
+	std::vector<std::vector<StateId>> m_Tables;
+
+	std::string GetSignature(const std::vector<std::pair<std::string, Transition>>& rules);
+	std::string CheckRule(const Transition& rule, std::vector<int>& directions);
+	bool Evaluate(const Transition& rule, std::vector<int>& counts);
+	void ApplyOnCell(StateId state, int k, Universe& cells, std::vector<char>& visited, std::vector<std::pair<int, StateId>>& applied);
+};
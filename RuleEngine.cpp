@@ -0,0 +1,469 @@
+#include "RuleEngine.h"
+
+#include <algorithm>
+#include <chrono>
+
+RuleEngine::RuleEngine()
+{
+}
+
+RuleEngine::~RuleEngine()
+{
+}
+
+void RuleEngine::Compile(const RuleSet& ruleSet)
+{
+	if (ruleSet.GetVersion() == m_CompiledVersion) return;
+
+	m_RuleCompiler.Compile(ruleSet.GetRules());
+	m_CompiledVersion = ruleSet.GetVersion();
+
+	// the new rules can change cells the old ones left alone
+	m_ActiveValid = false;
+}
+
+RuleCompiler& RuleEngine::GetCompiler()
+{
+	return m_RuleCompiler;
+}
+
+void RuleEngine::SetStop(std::function<bool()> stop)
+{
+	m_Stop = stop;
+}
+
+bool RuleEngine::Stopped()
+{
+	return m_Stop && m_Stop();
+}
+
+void RuleEngine::Step(const RuleSet& ruleSet, Universe& cells, ThreadPool& pool, int nBands, std::vector<Change>& changes, RuleProfiler* profiler)
+{
+	changes.clear();
+
+	// whatever the last call found is thrown away if it never made it into the cells
+	m_ActivePending = false;
+
+	const int rows = cells.GetRows();
+	const int cols = cells.GetCols();
+	const int N = cells.GetSize();
+
+	if (!N) return;
+
+	Compile(ruleSet);
+
+	const std::vector<std::pair<std::string, Transition>>& rules = ruleSet.GetRules();
+
+	auto start = std::chrono::steady_clock::now();
+
+	// the ghosts around the cells stand for whatever is past the edges
+	cells.RefreshGhosts();
+
+	// two-state rule sets are applied on bits, 64 cells at a time
+	if (m_BitKernel.Prepare(rules, m_RuleCompiler, cells))
+	{
+		m_BitKernel.Step(m_RuleCompiler, pool, changes);
+
+		if (profiler) profiler->Record(rules, RuleProfiler::STRATEGY_BITS, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), N, changes.size());
+
+		return;
+	}
+
+	// every compiled state only needs one pass
+	std::vector<StateId> compiled;
+	for (auto& rule : rules)
+	{
+		StateId from = rule.second.fromId;
+
+		if (m_RuleCompiler.IsCompiled(from) && std::find(compiled.begin(), compiled.end(), from) == compiled.end()) compiled.push_back(from);
+	}
+
+	// a cell can only change if something in its neighborhood changed during the last generation;
+	// all cells are evaluated again if the cells were edited, the rules changed or a rule keeps
+	// the state it applies on (those apply on quiet cells too, like "FREE / FREE" around nothing)
+	bool active = m_ActiveValid && m_ActiveVersion == cells.GetVersion() && m_Visited.size() == N;
+	for (auto& rule : rules)
+	{
+		if (rule.second.fromId == rule.second.stateId) active = false;
+	}
+
+	// a change is seen further away than the cells around it
+	if (ruleSet.IsLarge()) active = false;
+
+	// split the universe into bands of rows; a cell is only ever evaluated by the band
+	// it belongs to, so "visited" keeps the order of the rules without any locking
+	nBands = std::max(1, std::min(rows, nBands));
+	int bandRows = (rows + nBands - 1) / nBands;
+	nBands = (rows + bandRows - 1) / bandRows;
+
+	std::vector<std::vector<int>> bandActive;
+	if (active)
+	{
+		// only the cells that will be evaluated need to be unmarked
+		bandActive.assign(nBands, {});
+		for (int k : m_Active)
+		{
+			m_Visited[k] = false;
+			bandActive[k / cols / bandRows].push_back(k);
+		}
+	}
+	else
+	{
+		m_Visited.assign(N, false);
+		cells.BuildBands(bandRows);
+	}
+
+	std::vector<std::vector<std::vector<int>>> bandRules(nBands, std::vector<std::vector<int>>(rules.size()));
+	std::vector<std::vector<std::vector<std::pair<int, StateId>>>> bandCompiled(nBands, std::vector<std::vector<std::pair<int, StateId>>>(compiled.size()));
+	std::vector<std::vector<RuleProfiler::Entry>> bandProfile(nBands, std::vector<RuleProfiler::Entry>(rules.size()));
+
+	// conditions of the rules applied cell by cell read the neighbor counts, when there are any
+	m_NeighborCounts.Prepare(rules, m_RuleCompiler, cells);
+	m_ShapeCounts.Prepare(rules, cells, pool);
+
+	pool.For(nBands, std::bind(&RuleEngine::ParseBand, this, std::placeholders::_1, std::ref(cells),
+		std::ref(rules), std::ref(compiled), std::ref(bandActive), std::ref(bandRules), std::ref(bandCompiled), std::ref(bandProfile)));
+
+	if (Stopped()) return;
+
+	if (profiler) profiler->Record(rules, bandProfile);
+
+	// merge the changes in order of rules and bands, the same no matter how many threads ran
+	for (int i = 0; i < rules.size(); i++)
+	{
+		StateId to = rules[i].second.stateId;
+
+		for (int band = 0; band < nBands; band++)
+		{
+			for (int k : bandRules[band][i]) changes.push_back({ k, cells.Get(k), to });
+		}
+	}
+
+	for (int i = 0; i < compiled.size(); i++)
+	{
+		for (int band = 0; band < nBands; band++)
+		{
+			for (auto& change : bandCompiled[band][i]) changes.push_back({ change.first, compiled[i], change.second });
+		}
+	}
+
+	// cells around this generation's changes are the only ones evaluated next time
+	m_ActiveMark.resize(N, false);
+	m_ActiveNext.clear();
+
+	for (auto& change : changes)
+	{
+		int x = change.cell % cols;
+		int y = change.cell / cols;
+
+		for (int d = 0; d < N_DIRECTIONS; d++)
+		{
+			// neighbors across the edges as well
+			int k = cells.Map(x + DIRECTION_DX[d], y + DIRECTION_DY[d]);
+
+			if (k != -1 && !m_ActiveMark[k])
+			{
+				m_ActiveMark[k] = true;
+				m_ActiveNext.push_back(k);
+			}
+		}
+	}
+
+	for (int k : m_ActiveNext) m_ActiveMark[k] = false;
+	m_ActivePending = true;
+}
+
+void RuleEngine::Commit(std::vector<Change>& changes, Universe& cells)
+{
+	// the bits of the last step are now the same as the cells
+	m_BitKernel.Commit(cells);
+	m_NeighborCounts.Update(changes, cells);
+
+	if (!m_ActivePending) return;
+
+	m_Active.swap(m_ActiveNext);
+	m_ActiveVersion = cells.GetVersion();
+	m_ActiveValid = true;
+	m_ActivePending = false;
+}
+
+void RuleEngine::ParseBand(
+	int band,
+	Universe& cells,
+	const std::vector<std::pair<std::string, Transition>>& rules,
+	std::vector<StateId>& compiled,
+	std::vector<std::vector<int>>& bandActive,
+	std::vector<std::vector<std::vector<int>>>& bandRules,
+	std::vector<std::vector<std::vector<std::pair<int, StateId>>>>& bandCompiled,
+	std::vector<std::vector<RuleProfiler::Entry>>& bandProfile
+)
+{
+	// the rules which aren't compiled go first, in order
+	for (int i = 0; i < rules.size(); i++)
+	{
+		if (Stopped()) return;
+
+		// applied through the lookup tables below
+		if (m_RuleCompiler.IsCompiled(rules[i].second.fromId)) continue;
+
+		RuleProfiler::Entry& profile = bandProfile[band][i];
+		auto start = std::chrono::steady_clock::now();
+
+		if (bandActive.size()) ParseRuleActive(rules[i], cells, bandActive[band], bandRules[band][i], profile);
+		else ParseRule(rules[i], cells, band, bandRules[band][i], profile);
+
+		profile.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		profile.matches = bandRules[band][i].size();
+	}
+
+	for (int i = 0; i < compiled.size(); i++)
+	{
+		if (Stopped()) return;
+
+		// the table is shared by every rule of this state, so the first of them gets the profile
+		int first = 0;
+		while (rules[first].second.fromId != compiled[i]) first++;
+
+		RuleProfiler::Entry& profile = bandProfile[band][first];
+		profile.strategy = RuleProfiler::STRATEGY_COMPILED;
+
+		auto start = std::chrono::steady_clock::now();
+
+		if (bandActive.size())
+		{
+			profile.candidates = bandActive[band].size();
+			m_RuleCompiler.Apply(compiled[i], cells, bandActive[band], m_Visited, bandCompiled[band][i]);
+		}
+		else
+		{
+			const int rowBegin = band * cells.GetBandRows();
+			const int rowEnd = std::min(cells.GetRows(), rowBegin + cells.GetBandRows());
+
+			profile.candidates = compiled[i] == STATE_FREE ? (rowEnd - rowBegin) * cells.GetCols() : cells.GetBand(compiled[i], band).size();
+			m_RuleCompiler.Apply(compiled[i], cells, m_Visited, bandCompiled[band][i], band);
+		}
+
+		profile.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		profile.matches = bandCompiled[band][i].size();
+	}
+}
+
+void RuleEngine::ParseRule(const std::pair<std::string, Transition>& rule, Universe& cells, int band, std::vector<int>& applied, RuleProfiler::Entry& profile)
+{
+	StateId from = rule.second.fromId;
+
+	// "FREE" cells aren't indexed, there's always some of them
+	if (from != STATE_FREE && !cells.CountState(from)) return;
+
+	const StateId* grid = cells.GetCells();
+	const int cols = cells.GetCols();
+
+	// only the cells of this band of rows are evaluated
+	const int rowBegin = band * cells.GetBandRows();
+	const int rowEnd = std::min(cells.GetRows(), rowBegin + cells.GetBandRows());
+
+	auto evaluate = [&](int k)
+	{
+		if (grid[k] == from && !m_Visited[k] && ApplyOnCell(k, rule.second, cells))
+		{
+			applied.push_back(k);
+			m_Visited[k] = true;
+		}
+	};
+
+	// every cell of the first state in this band
+	auto evaluateAll = [&]()
+	{
+		if (from == STATE_FREE)
+		{
+			profile.candidates += (rowEnd - rowBegin) * cols;
+
+			for (int k = rowBegin * cols; k < rowEnd * cols; k++) evaluate(k);
+		}
+		else
+		{
+			const std::vector<int>& positions = cells.GetBand(from, band);
+			profile.candidates += positions.size();
+
+			for (int k : positions) evaluate(k);
+		}
+	};
+
+	// decide if it's faster to iterate through all cells
+	// or through the condition states' neighbors
+	bool neighbors = false;
+	if (!rule.second.all && rule.second.condition.size())
+	{
+		int n1 = cells.CountState(from);
+		int n2 = 0;
+		for (auto& state : rule.second.stateIds)
+		{
+			n2 += cells.CountState(state);
+
+			// cells next to a border can't be found through the cells of the universe
+			if (cells.IsBorder(state)) n2 += cells.GetSize();
+		}
+
+		neighbors = n1 > n2;
+	}
+
+	// faster to iterate through all cells
+	if (!neighbors)
+	{
+		profile.strategy = RuleProfiler::STRATEGY_ALL;
+		evaluateAll();
+
+		return;
+	}
+
+	// faster to iterate through the condition states' neighbors
+	profile.strategy = RuleProfiler::STRATEGY_NEIGHBORS;
+
+	int dx[9] = { 0,1,1,1,0,-1,-1,-1,0 };
+	int dy[9] = { -1,-1,0,1,1,1,0,-1,0 };
+
+	// past the edges (unless there's nothing or a border) a cell can be its own neighbor
+	const int nAround = cells.GetTopology() == TOPOLOGY_BOUNDED || cells.GetTopology() == TOPOLOGY_BORDER ? 8 : 9;
+
+	for (auto& state : rule.second.stateIds)
+	{
+		if (state == STATE_FREE) evaluateAll();
+		// cells of this type are placed on grid
+		else if (cells.CountState(state))
+		{
+			// neighbors of the cells in this band might be in the bands next to it (or across the edges)
+			for (int b : cells.GetBandsAround(band))
+			{
+				const std::vector<int>& positions = cells.GetBand(state, b);
+				profile.candidates += positions.size() * nAround;
+
+				for (int i : positions)
+				{
+					int x = i % cols;
+					int y = i / cols;
+
+					for (int d = 0; d < nAround; d++)
+					{
+						int k = cells.Map(x + dx[d], y + dy[d]);
+						if (k == -1 || k / cols < rowBegin || k / cols >= rowEnd) continue;
+
+						evaluate(k);
+					}
+				}
+			}
+		}
+	}
+}
+
+void RuleEngine::ParseRuleActive(const std::pair<std::string, Transition>& rule, Universe& cells, std::vector<int>& active, std::vector<int>& applied, RuleProfiler::Entry& profile)
+{
+	profile.strategy = RuleProfiler::STRATEGY_ACTIVE;
+	profile.candidates += active.size();
+
+	StateId from = rule.second.fromId;
+	const StateId* grid = cells.GetCells();
+
+	// same as iterating through all cells, but only the ones that might change
+	for (int k : active)
+	{
+		if (grid[k] == from && !m_Visited[k] && ApplyOnCell(k, rule.second, cells))
+		{
+			applied.push_back(k);
+			m_Visited[k] = true;
+		}
+	}
+}
+
+bool RuleEngine::ApplyOnCell(int k, const Transition& rule, Universe& cells)
+{
+	// only looked at when a condition isn't counted by m_NeighborCounts
+	StateId neighborhood[N_DIRECTIONS];
+	bool gathered = false;
+
+	bool ruleValid = true;
+	// iterate through the chain of "OR" rules
+	for (int i = 0; i < rule.idRules.size(); i++)
+	{
+		ruleValid = true;
+
+		// iterate through the chain of "AND" rules
+		for (int j = 0; j < rule.idRules[i].size(); j++)
+		{
+			auto& rulesAnd = rule.idRules[i][j];
+			const std::vector<int>& ruleNeighborhood = rulesAnd.first;
+
+			// large neighborhoods are always counted by m_ShapeCounts
+			const Shape& shape = rule.idShapes[i][j];
+			bool counted = m_NeighborCounts.Covers(rule.idMasks[i][j]);
+
+			bool conditionValid = true;
+			// iterate through the chain of "OR" conditions
+			for (auto& conditionsOr : rulesAnd.second)
+			{
+				conditionValid = true;
+
+				// iterate through the chain of "AND" conditions
+				for (auto& conditionsAnd : conditionsOr)
+				{
+					StateId conditionState = conditionsAnd.second;
+
+					int occurences = 0;
+					int slot = counted ? m_NeighborCounts.GetSlot(conditionState) : -1;
+
+					if (shape.type != SHAPE_NONE) occurences = m_ShapeCounts.Get(shape.slot, conditionState, k);
+					else if (slot != -1) occurences = m_NeighborCounts.Get(k, slot);
+					else
+					{
+						// mark the state of every direction; the ghosts stand for whatever is past the edges
+						// (out of bounds cells don't match any state, unless there's a border)
+						if (!gathered)
+						{
+							const StateId* padded = cells.GetPadded();
+							const int P = cells.GetPaddedCols();
+							const int p = (k / cells.GetCols() + 1) * P + k % cells.GetCols() + 1;
+
+							for (int d = 0; d < N_DIRECTIONS; d++) neighborhood[d] = padded[p + DIRECTION_DY[d] * P + DIRECTION_DX[d]];
+
+							gathered = true;
+						}
+
+						for (int d : ruleNeighborhood)
+						{
+							if (neighborhood[d] == conditionState) occurences++;
+						}
+					}
+
+					int conditionNumber = conditionsAnd.first.first;
+					int conditionType = conditionsAnd.first.second;
+
+					switch (conditionType)
+					{
+					case TYPE_EQUAL:
+						if (occurences != conditionNumber) conditionValid = false;
+						break;
+					case TYPE_LESS:
+						if (occurences >= conditionNumber) conditionValid = false;
+						break;
+					case TYPE_MORE:
+						if (occurences <= conditionNumber) conditionValid = false;
+						break;
+					default:
+						break;
+					}
+				}
+
+				if (conditionValid) break;
+			}
+
+			if (!conditionValid)
+			{
+				ruleValid = false;
+				break;
+			}
+		}
+
+		if (ruleValid) break;
+	}
+
+	return ruleValid;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+
+#include "Transition.h"
+#include "StateRegistry.h"
+#include "RuleSet.h"
+#include "Universe.h"
+#include "RuleCompiler.h"
+#include "BitKernel.h"
+#include "NeighborCounts.h"
+#include "ShapeCounts.h"
+#include "ThreadPool.h"
+#include "RuleProfiler.h"
+
+// applies a rule set on a universe, one generation at a time: on bits, through lookup tables or rule by rule,
+// on bands of rows split between threads and only around the last changes when that's enough; the grid,
+// the genetic algorithm and the command line tools all run their generations through it
+class RuleEngine
+{
+public:
+	RuleEngine();
+	~RuleEngine();
+
+	// rules that only count neighbors are turned into lookup tables, once for every rule set
+	void Compile(const RuleSet& ruleSet);
+	RuleCompiler& GetCompiler();
+
+	// checked before every rule, a generation stopped halfway has no changes
+	void SetStop(std::function<bool()> stop);
+
+	// changes of the next generation, in order of the rules (the cells stay the same); the universe is split
+	// into at most nBands bands of rows, which run on the pool; profiler = nullptr if nobody reads the costs
+	void Step(const RuleSet& ruleSet, Universe& cells, ThreadPool& pool, int nBands, std::vector<Change>& changes, RuleProfiler* profiler = nullptr);
+
+	// the changes (made by Step or by anything else) are now in the cells
+	void Commit(std::vector<Change>& changes, Universe& cells);
+private:
+	RuleCompiler m_RuleCompiler;
+	unsigned long long m_CompiledVersion = 0;
+	BitKernel m_BitKernel;
+
+	// neighbors of every state the conditions count, updated with the changes of every generation
+	NeighborCounts m_NeighborCounts;
+
+	// cells of the large neighborhoods (see Shape.h), counted again every generation
+	ShapeCounts m_ShapeCounts;
+
+	std::function<bool()> m_Stop;
+
+	// cells already claimed by a rule during the current generation
+	std::vector<char> m_Visited;
+
+	// cells around the changes of the last generation, valid as long as the cells
+	// are still the way that generation left them (see m_ActiveVersion)
+	std::vector<int> m_Active;
+	std::vector<int> m_ActiveNext;
+	std::vector<char> m_ActiveMark;
+	unsigned long long m_ActiveVersion = 0;
+	bool m_ActiveValid = false;
+	bool m_ActivePending = false;
+
+	bool Stopped();
+
+	void ParseBand(
+		int band,
+		Universe& cells,
+		const std::vector<std::pair<std::string, Transition>>& rules,
+		std::vector<StateId>& compiled,
+		std::vector<std::vector<int>>& bandActive,
+		std::vector<std::vector<std::vector<int>>>& bandRules,
+		std::vector<std::vector<std::vector<std::pair<int, StateId>>>>& bandCompiled,
+		std::vector<std::vector<RuleProfiler::Entry>>& bandProfile
+	);
+	void ParseRule(const std::pair<std::string, Transition>& rule, Universe& cells, int band, std::vector<int>& applied, RuleProfiler::Entry& profile);
+	void ParseRuleActive(const std::pair<std::string, Transition>& rule, Universe& cells, std::vector<int>& active, std::vector<int>& applied, RuleProfiler::Entry& profile);
+	bool ApplyOnCell(int k, const Transition& rule, Universe& cells);
+};
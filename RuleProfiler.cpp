@@ -0,0 +1,161 @@
+#include "RuleProfiler.h"
+
+#include <sstream>
+
+RuleProfiler::RuleProfiler()
+{
+}
+
+RuleProfiler::~RuleProfiler()
+{
+}
+
+std::string RuleProfiler::GetStrategyName(Strategy strategy)
+{
+	switch (strategy)
+	{
+	case STRATEGY_ALL:
+		return "all cells";
+	case STRATEGY_NEIGHBORS:
+		return "neighbors";
+	case STRATEGY_ACTIVE:
+		return "active cells";
+	case STRATEGY_COMPILED:
+		return "lookup table";
+	case STRATEGY_BITS:
+		return "bits";
+	case STRATEGY_HASHLIFE:
+		return "hashlife";
+	case STRATEGY_PLANE:
+		return "endless plane";
+	default:
+		return "";
+	}
+}
+
+void RuleProfiler::Record(const std::vector<std::pair<std::string, Transition>>& rules, std::vector<std::vector<Entry>>& entries)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	Prepare(rules);
+
+	for (int i = 0; i < rules.size(); i++)
+	{
+		Entry last;
+		for (auto& band : entries)
+		{
+			// a band that scanned nothing still tells which strategy was picked
+			if (band[i].strategy != STRATEGY_NONE) last.strategy = band[i].strategy;
+
+			last.seconds += band[i].seconds;
+			last.candidates += band[i].candidates;
+			last.matches += band[i].matches;
+		}
+
+		Row& row = m_Rows[i];
+		row.last = last;
+		row.total.strategy = last.strategy;
+		row.total.seconds += last.seconds;
+		row.total.candidates += last.candidates;
+		row.total.matches += last.matches;
+	}
+
+	m_Generations++;
+}
+
+void RuleProfiler::Record(const std::vector<std::pair<std::string, Transition>>& rules, Strategy strategy, double seconds, long long candidates, long long matches)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	Prepare(rules);
+
+	// nothing can be told apart, so everything goes to the first rule
+	for (int i = 0; i < rules.size(); i++)
+	{
+		Row& row = m_Rows[i];
+		row.last = Entry();
+		row.last.strategy = strategy;
+
+		if (i == 0)
+		{
+			row.last.seconds = seconds;
+			row.last.candidates = candidates;
+			row.last.matches = matches;
+		}
+
+		row.total.strategy = strategy;
+		row.total.seconds += row.last.seconds;
+		row.total.candidates += row.last.candidates;
+		row.total.matches += row.last.matches;
+	}
+
+	m_Generations++;
+}
+
+long long RuleProfiler::GetGenerations()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	return m_Generations;
+}
+
+std::vector<RuleProfiler::Row> RuleProfiler::GetRows()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	return m_Rows;
+}
+
+void RuleProfiler::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	m_Rows.clear();
+	m_Generations = 0;
+}
+
+std::string RuleProfiler::ToCsv()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	std::stringstream csv;
+	csv << "number,rule,strategy,last_us,last_candidates,last_matches,total_us,total_candidates,total_matches,average_us,generations\n";
+
+	for (int i = 0; i < m_Rows.size(); i++)
+	{
+		Row& row = m_Rows[i];
+
+		// rules can contain commas
+		std::string rule = row.rule;
+		for (size_t quote = rule.find('"'); quote != std::string::npos; quote = rule.find('"', quote + 2)) rule.insert(quote, "\"");
+
+		csv << i + 1 << ",\"" << rule << "\"," << GetStrategyName(row.last.strategy) << ",";
+		csv << row.last.seconds * 1e6 << "," << row.last.candidates << "," << row.last.matches << ",";
+		csv << row.total.seconds * 1e6 << "," << row.total.candidates << "," << row.total.matches << ",";
+		csv << (m_Generations ? row.total.seconds * 1e6 / m_Generations : 0) << "," << m_Generations << "\n";
+	}
+
+	return csv.str();
+}
+
+void RuleProfiler::Prepare(const std::vector<std::pair<std::string, Transition>>& rules)
+{
+	// other rules than last time -> start over
+	bool same = rules.size() == m_Rows.size();
+	for (int i = 0; same && i < rules.size(); i++) same = GetRuleName(rules[i]) == m_Rows[i].rule;
+
+	if (same) return;
+
+	m_Rows.assign(rules.size(), Row());
+	for (int i = 0; i < rules.size(); i++) m_Rows[i].rule = GetRuleName(rules[i]);
+
+	m_Generations = 0;
+}
+
+std::string RuleProfiler::GetRuleName(const std::pair<std::string, Transition>& rule)
+{
+	std::string name = rule.first + "/" + rule.second.state;
+	if (!rule.second.condition.empty()) name += ":" + rule.second.condition;
+
+	return name;
+}
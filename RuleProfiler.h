@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <mutex>
+
+#include "Transition.h"
+
+// what every rule cost during the last generation, and since the profile was cleared;
+// filled in by the generating thread, read by the interface
+class RuleProfiler
+{
+public:
+	// how the cells a rule applies on were found
+	enum Strategy
+	{
+		STRATEGY_NONE,
+		// every cell of the first state (or the whole universe, for "FREE")
+		STRATEGY_ALL,
+		// only the neighbors of the condition states (n1 > n2)
+		STRATEGY_NEIGHBORS,
+		// only the cells around the changes of the last generation
+		STRATEGY_ACTIVE,
+		// lookup table, shared by every rule of the first state
+		STRATEGY_COMPILED,
+		// the whole rule set at once: on bits, with HashLife or on the endless plane
+		STRATEGY_BITS,
+		STRATEGY_HASHLIFE,
+		STRATEGY_PLANE
+	};
+
+	struct Entry
+	{
+		Strategy strategy = STRATEGY_NONE;
+		double seconds = 0;
+		long long candidates = 0;
+		long long matches = 0;
+	};
+
+	struct Row
+	{
+		std::string rule;
+		Entry last;
+		Entry total;
+	};
+
+	RuleProfiler();
+	~RuleProfiler();
+
+	static std::string GetStrategyName(Strategy strategy);
+
+	// generating thread; entries[band][rule] are summed over the bands (the time is the time of all threads)
+	void Record(const std::vector<std::pair<std::string, Transition>>& rules, std::vector<std::vector<Entry>>& entries);
+
+	// the whole rule set ran through a single engine
+	void Record(const std::vector<std::pair<std::string, Transition>>& rules, Strategy strategy, double seconds, long long candidates, long long matches);
+
+	long long GetGenerations();
+	std::vector<Row> GetRows();
+	void Clear();
+
+	// one line for every rule: last generation, sum and average over all generations
+	std::string ToCsv();
+private:
+	std::mutex m_Mutex;
+
+	long long m_Generations = 0;
+	std::vector<Row> m_Rows;
+
+	void Prepare(const std::vector<std::pair<std::string, Transition>>& rules);
+	std::string GetRuleName(const std::pair<std::string, Transition>& rule);
+};
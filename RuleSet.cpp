@@ -0,0 +1,123 @@
+#include "RuleSet.h"
+
+#include <atomic>
+
+RuleSet::RuleSet() : m_Version(NextVersion())
+{
+}
+
+RuleSet::RuleSet(const std::vector<std::pair<std::string, Transition>>& rules, const std::vector<std::string>& states,
+	const std::unordered_set<std::string>& neighbors, StateRegistry& registry)
+	: m_Version(NextVersion()), m_Rules(rules), m_States(states.begin(), states.end()), m_Neighbors(neighbors)
+{
+	for (int i = 0; i < m_Rules.size(); i++)
+	{
+		m_Error = CheckRule(m_Rules[i]);
+
+		if (m_Error.size())
+		{
+			m_ErrorRule = i;
+			return;
+		}
+	}
+
+	// from now on work only with state ids
+	for (int i = 0; i < m_Rules.size(); i++)
+	{
+		auto& rule = m_Rules[i];
+
+		if (!registry.Resolve(rule.first, rule.second, m_Neighbors))
+		{
+			m_Error = "<TOO MANY STATES>";
+			m_ErrorRule = i;
+			return;
+		}
+
+		if (rule.second.large) m_Large = true;
+	}
+
+	// the same cells get the same slot of ShapeCounts, whichever rule they're in
+	std::vector<std::string> keys;
+	for (auto& rule : m_Rules)
+	{
+		for (auto& shapes : rule.second.idShapes)
+		{
+			for (auto& shape : shapes)
+			{
+				if (shape.type == SHAPE_NONE) continue;
+
+				int slot = 0;
+				while (slot < keys.size() && keys[slot] != shape.key) slot++;
+
+				if (slot == keys.size()) keys.push_back(shape.key);
+
+				shape.slot = slot;
+			}
+		}
+	}
+}
+
+RuleSet::~RuleSet()
+{
+}
+
+unsigned long long RuleSet::GetVersion() const
+{
+	return m_Version;
+}
+
+const std::string& RuleSet::GetError() const
+{
+	return m_Error;
+}
+
+int RuleSet::GetErrorRule() const
+{
+	return m_ErrorRule;
+}
+
+const std::vector<std::pair<std::string, Transition>>& RuleSet::GetRules() const
+{
+	return m_Rules;
+}
+
+const std::unordered_set<std::string>& RuleSet::GetStates() const
+{
+	return m_States;
+}
+
+const std::unordered_set<std::string>& RuleSet::GetNeighbors() const
+{
+	return m_Neighbors;
+}
+
+bool RuleSet::IsLarge() const
+{
+	return m_Large;
+}
+
+std::string RuleSet::CheckRule(const std::pair<std::string, Transition>& rule)
+{
+	// check if rule might contain invalid states
+	if (m_States.find(rule.first) == m_States.end()) return "<INVALID FIRST STATE>";
+	if (m_States.find(rule.second.state) == m_States.end()) return "<INVALID SECOND STATE>";
+	for (auto& state : rule.second.states)
+	{
+		if (m_States.find(state) == m_States.end()) return "<INVALID CONDITION STATE>";
+	}
+	// check for neighborhood as well
+	for (auto& direction : rule.second.directions)
+	{
+		if (m_Neighbors.find(direction) == m_Neighbors.end()) return "<INVALID NEIGHBORHOOD>";
+	}
+
+	return "";
+}
+
+unsigned long long RuleSet::NextVersion()
+{
+	// rule sets are built by the interface and by the GA at the same time
+	static std::atomic<unsigned long long> version{ 0 };
+
+	return ++version;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <unordered_set>
+
+#include "Transition.h"
+#include "StateRegistry.h"
+
+// the rules, the states and the neighbors of an automaton as they were after an edit: checked and
+// resolved into ids only once, then shared as they are by everyone running them (nothing changes
+// them after the constructor, a new edit means a new rule set)
+class RuleSet
+{
+public:
+	// no rules at all
+	RuleSet();
+
+	// every state of the rules has to be one of the states and every direction one of the neighbors;
+	// if they are, the names are resolved through the registry (see StateRegistry::Resolve)
+	RuleSet(const std::vector<std::pair<std::string, Transition>>& rules, const std::vector<std::string>& states,
+		const std::unordered_set<std::string>& neighbors, StateRegistry& registry);
+	~RuleSet();
+
+	// different for every rule set
+	unsigned long long GetVersion() const;
+
+	// "" if the rules can run, otherwise the first problem found and the index of its rule
+	const std::string& GetError() const;
+	int GetErrorRule() const;
+
+	const std::vector<std::pair<std::string, Transition>>& GetRules() const;
+	const std::unordered_set<std::string>& GetStates() const;
+	const std::unordered_set<std::string>& GetNeighbors() const;
+
+	// does any rule count a neighborhood larger than the directions (see Shape.h)?
+	bool IsLarge() const;
+private:
+	unsigned long long m_Version = 0;
+
+	std::vector<std::pair<std::string, Transition>> m_Rules;
+	std::unordered_set<std::string> m_States;
+	std::unordered_set<std::string> m_Neighbors;
+
+	std::string m_Error = "";
+	int m_ErrorRule = -1;
+
+	bool m_Large = false;
+
+	std::string CheckRule(const std::pair<std::string, Transition>& rule);
+	static unsigned long long NextVersion();
+};
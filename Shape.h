@@ -0,0 +1,98 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include <cctype>
+
+// neighborhoods past the 9 directions of Transition.h, counted by ShapeCounts
+#define SHAPE_NONE 0 // the directions of the rule
+#define SHAPE_MOORE 1 // every cell within <radius> rows and columns, e.g. "MOORE5"
+#define SHAPE_VONNEUMANN 2 // every cell within <radius> steps, e.g. "VONNEUMANN3"
+#define SHAPE_CUSTOM 3 // a set of offsets, e.g. "[N2, E2, S2, W2]"
+
+// neither of them goes past this many cells from the center
+#define RADIUS_MAX 16
+
+struct Shape
+{
+	int type = SHAPE_NONE;
+	int radius = 0;
+
+	// (dx, dy) of every cell of a custom shape, sorted by rows
+	std::vector<std::pair<int, int>> offsets;
+
+	// same key = same cells, whichever rule they were written in
+	std::string key;
+
+	// of ShapeCounts, the same for the same key (assigned by RuleSet)
+	int slot = -1;
+};
+
+// "MOORE<radius>" or "VONNEUMANN<radius>"; the center isn't part of them (it's counted by "C")
+inline bool GetShape(const std::string& name, Shape& shape)
+{
+	const std::string types[2] = { "MOORE", "VONNEUMANN" };
+
+	for (int t = 0; t < 2; t++)
+	{
+		if (name.compare(0, types[t].size(), types[t]) != 0) continue;
+
+		std::string radius = name.substr(types[t].size());
+		if (radius.empty() || radius.size() > 2 || radius.find_first_not_of("0123456789") != std::string::npos) return false;
+
+		int r = std::stoi(radius);
+		if (r < 1 || r > RADIUS_MAX) return false;
+
+		shape.type = t == 0 ? SHAPE_MOORE : SHAPE_VONNEUMANN;
+		shape.radius = r;
+		shape.offsets.clear();
+		shape.key = name;
+
+		return true;
+	}
+
+	return false;
+}
+
+// "C" or steps towards the cardinal directions, each followed by how many (1 if there's no number), e.g. "N2E1" or "SW"
+inline bool GetOffset(const std::string& name, int& dx, int& dy)
+{
+	dx = dy = 0;
+
+	if (name == "C") return true;
+	if (name.empty()) return false;
+
+	bool seen[4] = { false, false, false, false };
+
+	for (size_t i = 0; i < name.size();)
+	{
+		const std::string letters = "NSEW";
+
+		size_t l = letters.find(name[i]);
+		if (l == std::string::npos || seen[l]) return false;
+		seen[l] = true;
+
+		size_t j = ++i;
+		while (j < name.size() && isdigit(name[j])) j++;
+
+		int steps = 1;
+		if (j > i)
+		{
+			if (j - i > 2) return false;
+			steps = std::stoi(name.substr(i, j - i));
+		}
+		i = j;
+
+		if (steps < 1 || steps > RADIUS_MAX) return false;
+
+		if (l == 0) dy -= steps;
+		if (l == 1) dy += steps;
+		if (l == 2) dx += steps;
+		if (l == 3) dx -= steps;
+	}
+
+	// "NS" or "EW" go nowhere
+	if ((seen[0] && seen[1]) || (seen[2] && seen[3])) return false;
+
+	return true;
+}
@@ -0,0 +1,336 @@
+#include "ShapeCounts.h"
+
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+
+ShapeCounts::ShapeCounts()
+{
+}
+
+ShapeCounts::~ShapeCounts()
+{
+}
+
+bool ShapeCounts::Prepare(const std::vector<std::pair<std::string, Transition>>& rules, Universe& cells, ThreadPool& pool)
+{
+	// shapes of the rules by slot (see RuleSet) and the states counted in each of them
+	std::vector<Shape> shapes;
+	std::vector<std::vector<StateId>> states;
+
+	for (auto& rule : rules)
+	{
+		for (int i = 0; i < rule.second.idShapes.size(); i++)
+		{
+			for (int j = 0; j < rule.second.idShapes[i].size(); j++)
+			{
+				const Shape& shape = rule.second.idShapes[i][j];
+				if (shape.type == SHAPE_NONE || shape.slot == -1) continue;
+
+				int slot = shape.slot;
+				if (slot >= shapes.size())
+				{
+					shapes.resize(slot + 1);
+					states.resize(slot + 1);
+				}
+
+				shapes[slot] = shape;
+
+				for (auto& conditionsOr : rule.second.idRules[i][j].second)
+				{
+					for (auto& conditionsAnd : conditionsOr)
+					{
+						StateId state = conditionsAnd.second;
+
+						if (state == STATE_INVALID) continue;
+						if (std::find(states[slot].begin(), states[slot].end(), state) == states[slot].end()) states[slot].push_back(state);
+					}
+				}
+			}
+		}
+	}
+
+	if (shapes.empty())
+	{
+		Clear();
+		return false;
+	}
+
+	for (auto& counted : states) std::sort(counted.begin(), counted.end());
+
+	// something else to count than last time
+	bool same = shapes.size() == m_Shapes.size() && states == m_States;
+	for (int slot = 0; same && slot < shapes.size(); slot++)
+	{
+		if (shapes[slot].key != m_Shapes[slot].key) same = false;
+	}
+
+	if (!same)
+	{
+		m_Shapes = shapes;
+		m_States = states;
+		m_Loaded = false;
+
+		m_Pairs.clear();
+		m_Index.assign(shapes.size(), {});
+		for (int slot = 0; slot < shapes.size(); slot++)
+		{
+			if (states[slot].empty()) continue;
+
+			m_Index[slot].assign(states[slot].back() + 1, -1);
+			for (StateId state : states[slot])
+			{
+				m_Index[slot][state] = m_Pairs.size();
+				m_Pairs.push_back({ slot, state });
+			}
+		}
+	}
+
+	// cells were edited (or went through a generation) since the last time
+	if (!m_Loaded || &cells != m_Source || cells.GetVersion() != m_Version || cells.GetHash() != m_Hash) Load(cells, pool);
+
+	return true;
+}
+
+void ShapeCounts::Clear()
+{
+	m_Shapes.clear();
+	m_States.clear();
+	m_Index.clear();
+
+	m_Pairs.clear();
+	m_Counts.clear();
+
+	m_Padded.clear();
+	m_Tabled.clear();
+	m_Kinds.clear();
+	m_Rows.clear();
+	m_Areas.clear();
+	m_Mains.clear();
+	m_Antis.clear();
+
+	m_Source = nullptr;
+	m_Loaded = false;
+}
+
+void ShapeCounts::Load(Universe& cells, ThreadPool& pool)
+{
+	const int rows = cells.GetRows();
+	const int cols = cells.GetCols();
+
+	m_Counts.resize(m_Pairs.size());
+	for (auto& counts : m_Counts) counts.assign(rows * cols, 0);
+
+	m_Source = &cells;
+	m_Version = cells.GetVersion();
+	m_Hash = cells.GetHash();
+	m_Loaded = true;
+
+	if (!rows || !cols) return;
+
+	int radius = 0;
+	for (auto& shape : m_Shapes)
+	{
+		radius = std::max(radius, shape.radius);
+		for (auto& offset : shape.offsets) radius = std::max(radius, std::max(std::abs(offset.first), std::abs(offset.second)));
+	}
+
+	// one more, so the sums right before the first cell of a shape are never outside
+	m_Margin = radius + 1;
+	m_Width = cols + 2 * m_Margin;
+	m_Height = rows + 2 * m_Margin;
+
+	m_Padded.resize(m_Width * m_Height);
+	pool.For(m_Height, std::bind(&ShapeCounts::LoadRow, this, std::placeholders::_1, std::cref(cells)));
+
+	// every counted state once, with the sums its shapes need
+	m_Tabled.clear();
+	m_Kinds.clear();
+	for (auto& pair : m_Pairs)
+	{
+		int type = m_Shapes[pair.first].type;
+		int kind = type == SHAPE_MOORE ? KIND_AREA : type == SHAPE_VONNEUMANN ? KIND_DIAGONALS : 0;
+
+		auto it = std::find(m_Tabled.begin(), m_Tabled.end(), pair.second);
+		if (it == m_Tabled.end())
+		{
+			m_Tabled.push_back(pair.second);
+			m_Kinds.push_back(kind);
+		}
+		else m_Kinds[it - m_Tabled.begin()] |= kind;
+	}
+
+	m_Rows.resize(m_Tabled.size());
+	m_Areas.resize(m_Tabled.size());
+	m_Mains.resize(m_Tabled.size());
+	m_Antis.resize(m_Tabled.size());
+	pool.For(m_Tabled.size(), std::bind(&ShapeCounts::LoadTables, this, std::placeholders::_1));
+
+	// split the cells into bands of rows, like the generations
+	int nBands = std::min(rows, pool.GetSize() * 4);
+	int bandRows = (rows + nBands - 1) / nBands;
+	nBands = (rows + bandRows - 1) / bandRows;
+
+	pool.For(nBands, std::bind(&ShapeCounts::LoadBand, this, std::placeholders::_1, bandRows, rows, cols));
+}
+
+void ShapeCounts::LoadRow(int py, const Universe& cells)
+{
+	const int rows = cells.GetRows();
+	const int cols = cells.GetCols();
+	const int y = py - m_Margin;
+
+	// past the edges, whatever the topology puts there
+	for (int px = 0; px < m_Width; px++)
+	{
+		const int x = px - m_Margin;
+
+		m_Padded[py * m_Width + px] = x >= 0 && x < cols && y >= 0 && y < rows ? cells.Get(x, y) : cells.GetWrapped(x, y);
+	}
+}
+
+void ShapeCounts::LoadTables(int t)
+{
+	const StateId state = m_Tabled[t];
+	const int W = m_Width;
+	const int H = m_Height;
+
+	std::vector<int>& row = m_Rows[t];
+	row.resize(W * H);
+
+	for (int py = 0; py < H; py++)
+	{
+		int sum = 0;
+		for (int k = py * W; k < (py + 1) * W; k++)
+		{
+			sum += m_Padded[k] == state;
+			row[k] = sum;
+		}
+	}
+
+	std::vector<int>& area = m_Areas[t];
+	if (m_Kinds[t] & KIND_AREA)
+	{
+		area.resize(W * H);
+		for (int k = 0; k < W * H; k++) area[k] = row[k] + (k >= W ? area[k - W] : 0);
+	}
+	else area.clear();
+
+	std::vector<int>& main = m_Mains[t];
+	std::vector<int>& anti = m_Antis[t];
+	if (m_Kinds[t] & KIND_DIAGONALS)
+	{
+		main.resize(W * H);
+		anti.resize(W * H);
+
+		for (int py = 0; py < H; py++)
+		{
+			for (int px = 0; px < W; px++)
+			{
+				const int k = py * W + px;
+				const int cell = m_Padded[k] == state;
+
+				// towards the top left and towards the top right
+				main[k] = cell + (py && px ? main[k - W - 1] : 0);
+				anti[k] = cell + (py && px + 1 < W ? anti[k - W + 1] : 0);
+			}
+		}
+	}
+	else
+	{
+		main.clear();
+		anti.clear();
+	}
+}
+
+void ShapeCounts::LoadBand(int band, int bandRows, int rows, int cols)
+{
+	const int W = m_Width;
+	const int M = m_Margin;
+
+	const int rowBegin = band * bandRows;
+	const int rowEnd = std::min(rows, rowBegin + bandRows);
+
+	for (int c = 0; c < m_Pairs.size(); c++)
+	{
+		const Shape& shape = m_Shapes[m_Pairs[c].first];
+		const StateId state = m_Pairs[c].second;
+		const int r = shape.radius;
+
+		const int t = std::find(m_Tabled.begin(), m_Tabled.end(), state) - m_Tabled.begin();
+		const int* row = m_Rows[t].data();
+		const int* area = m_Areas[t].data();
+		const int* main = m_Mains[t].data();
+		const int* anti = m_Antis[t].data();
+
+		int* counts = m_Counts[c].data();
+
+		// cells from (a, b) to (a + length, b + length) and from (a, b) to (a - length, b + length)
+		auto mainSum = [&](int a, int b, int length) { return main[(b + length) * W + a + length] - main[(b - 1) * W + a - 1]; };
+		auto antiSum = [&](int a, int b, int length) { return anti[(b + length) * W + a - length] - anti[(b - 1) * W + a + 1]; };
+
+		// a custom shape is read one run of neighbors on the same row at a time
+		struct Run { int dy, x0, x1; };
+		std::vector<Run> runs;
+		for (auto& offset : shape.offsets)
+		{
+			if (runs.size() && runs.back().dy == offset.second && runs.back().x1 + 1 == offset.first) runs.back().x1++;
+			else runs.push_back({ offset.second, offset.first, offset.first });
+		}
+
+		for (int y = rowBegin; y < rowEnd; y++)
+		{
+			const int py = y + M;
+
+			if (shape.type == SHAPE_MOORE)
+			{
+				const int top = (py - r - 1) * W;
+				const int bottom = (py + r) * W;
+
+				for (int x = 0, px = M; x < cols; x++, px++)
+				{
+					counts[y * cols + x] = area[bottom + px + r] - area[top + px + r] - area[bottom + px - r - 1] + area[top + px - r - 1]
+						- (m_Padded[py * W + px] == state);
+				}
+			}
+			else if (shape.type == SHAPE_VONNEUMANN)
+			{
+				// the first cell of the row is counted row by row, the diamond then slides along it
+				int count = 0;
+				for (int dy = -r; dy <= r; dy++)
+				{
+					const int w = r - std::abs(dy);
+					const int k = (py + dy) * W + M;
+
+					count += row[k + w] - row[k - w - 1];
+				}
+
+				for (int x = 0, px = M; x < cols; x++, px++)
+				{
+					counts[y * cols + x] = count - (m_Padded[py * W + px] == state);
+
+					if (x + 1 == cols) break;
+
+					// cells on the right edges of the diamond come in, the ones on the left edges go out
+					count += mainSum(px + 1, py - r, r) + antiSum(px + r, py + 1, r - 1);
+					count -= antiSum(px, py - r, r) + mainSum(px - r + 1, py + 1, r - 1);
+				}
+			}
+			else
+			{
+				for (int x = 0, px = M; x < cols; x++, px++)
+				{
+					int count = 0;
+					for (auto& run : runs)
+					{
+						const int k = (py + run.dy) * W + px;
+
+						count += row[k + run.x1] - row[k + run.x0 - 1];
+					}
+
+					counts[y * cols + x] = count;
+				}
+			}
+		}
+	}
+}
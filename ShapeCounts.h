@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <string>
+
+#include "Transition.h"
+#include "StateRegistry.h"
+#include "Universe.h"
+#include "ThreadPool.h"
+
+// for every cell, how many cells of each state counted by the conditions are in the large
+// neighborhoods of the rules (see Shape.h); taken from prefix sums of every state, so a cell
+// costs the same whatever the radius (a custom shape costs one read for every run of its rows)
+class ShapeCounts
+{
+public:
+	ShapeCounts();
+	~ShapeCounts();
+
+	// anything to count? the counts are taken again if the cells (or the shapes) changed
+	// since the last time; the shapes get their slots from RuleSet
+	bool Prepare(const std::vector<std::pair<std::string, Transition>>& rules, Universe& cells, ThreadPool& pool);
+
+	// cells of the state in the shape of the slot around cell k; only for the states its conditions count
+	inline int Get(int slot, StateId state, int k) const { return m_Counts[m_Index[slot][state]][k]; }
+
+	void Clear();
+private:
+	// by slot
+	std::vector<Shape> m_Shapes;
+	std::vector<std::vector<StateId>> m_States;
+	std::vector<std::vector<int>> m_Index;
+
+	// one array of rows*cols counts for every (slot, state)
+	std::vector<std::pair<int, StateId>> m_Pairs;
+	std::vector<std::vector<int>> m_Counts;
+
+	// the cells with a margin of whatever is past the edges, wide enough for the largest shape
+	int m_Margin = 0;
+	int m_Width = 0;
+	int m_Height = 0;
+	std::vector<StateId> m_Padded;
+
+	// inclusive prefix sums of every counted state over m_Padded: along the rows, both ways
+	// (summed-area table) and along both diagonals (only for the shapes that need them)
+	static const int KIND_AREA = 1;
+	static const int KIND_DIAGONALS = 2;
+
+	std::vector<StateId> m_Tabled;
+	std::vector<int> m_Kinds;
+	std::vector<std::vector<int>> m_Rows;
+	std::vector<std::vector<int>> m_Areas;
+	std::vector<std::vector<int>> m_Mains;
+	std::vector<std::vector<int>> m_Antis;
+
+	// cells the counts were taken from
+	const Universe* m_Source = nullptr;
+	unsigned long long m_Version = 0;
+	unsigned long long m_Hash = 0;
+	bool m_Loaded = false;
+
+	void Load(Universe& cells, ThreadPool& pool);
+	void LoadRow(int py, const Universe& cells);
+	void LoadTables(int t);
+	void LoadBand(int band, int bandRows, int rows, int cols);
+};
@@ -0,0 +1,204 @@
+#include "StateRegistry.h"
+#include "Transition.h"
+
+#include <algorithm>
+#include <functional>
+
+StateRegistry::StateRegistry()
+{
+	// "FREE" always gets the first id
+	Intern("FREE");
+}
+
+StateRegistry::StateRegistry(const std::vector<std::string>& states) : StateRegistry()
+{
+	// ids follow the order of the given list
+	for (auto& state : states) Intern(state);
+}
+
+StateRegistry::~StateRegistry()
+{
+}
+
+StateId StateRegistry::Intern(const std::string& state)
+{
+	auto it = m_Ids.find(state);
+	if (it != m_Ids.end()) return it->second;
+
+	// the smallest released id first, so the palette and the lookup tables stay small
+	StateId id;
+	if (m_Free.size())
+	{
+		id = m_Free.back();
+		m_Free.pop_back();
+
+		m_Names[id] = state;
+	}
+	else
+	{
+		if (m_Names.size() >= STATE_INVALID) return STATE_INVALID;
+
+		id = m_Names.size();
+		m_Names.push_back(state);
+	}
+
+	m_Ids.insert({ state, id });
+
+	return id;
+}
+
+StateId StateRegistry::Find(const std::string& state) const
+{
+	auto it = m_Ids.find(state);
+	if (it == m_Ids.end()) return STATE_INVALID;
+
+	return it->second;
+}
+
+const std::string& StateRegistry::GetName(StateId id) const
+{
+	static const std::string invalid = "";
+
+	if (id >= m_Names.size()) return invalid;
+
+	return m_Names[id];
+}
+
+bool StateRegistry::Rename(const std::string& oldState, const std::string& newState)
+{
+	// the new name is already taken -> the caller has to move the cells itself
+	if (m_Ids.find(newState) != m_Ids.end()) return false;
+
+	auto it = m_Ids.find(oldState);
+	if (it == m_Ids.end()) return false;
+
+	StateId id = it->second;
+
+	m_Ids.erase(it);
+	m_Ids.insert({ newState, id });
+	m_Names[id] = newState;
+
+	return true;
+}
+
+void StateRegistry::Release(const std::string& state)
+{
+	auto it = m_Ids.find(state);
+	if (it == m_Ids.end() || it->second == STATE_FREE) return;
+
+	StateId id = it->second;
+
+	m_Ids.erase(it);
+	m_Names[id] = "";
+
+	m_Free.insert(std::upper_bound(m_Free.begin(), m_Free.end(), id, std::greater<StateId>()), id);
+}
+
+int StateRegistry::Size() const
+{
+	return m_Names.size();
+}
+
+bool StateRegistry::Resolve(const std::string& state, Transition& transition, const std::unordered_set<std::string>& neighbors)
+{
+	// translate the names used by the transition into ids and direction indexes
+	transition.fromId = Intern(state);
+	transition.stateId = Intern(transition.state);
+
+	bool resolved = transition.fromId != STATE_INVALID && transition.stateId != STATE_INVALID;
+
+	transition.stateIds.clear();
+	for (auto& conditionState : transition.states)
+	{
+		transition.stateIds.push_back(Intern(conditionState));
+		if (transition.stateIds.back() == STATE_INVALID) resolved = false;
+	}
+
+	std::vector<int> allDirections;
+	for (int d = 0; d < N_DIRECTIONS; d++)
+	{
+		if (neighbors.find(DIRECTION_NAMES[d]) != neighbors.end()) allDirections.push_back(d);
+	}
+
+	transition.idRules.clear();
+	transition.idMasks.clear();
+	transition.idShapes.clear();
+	transition.large = false;
+	for (auto& rulesOr : transition.orRules)
+	{
+		ID_RULES_AND idRulesAnd;
+		std::vector<int> masks;
+		std::vector<Shape> shapes;
+
+		for (auto& rulesAnd : rulesOr)
+		{
+			// a neighborhood larger than the directions doesn't depend on the neighbors panel
+			Shape shape;
+			if (rulesAnd.first.size() == 1 && GetShape(rulesAnd.first[0], shape)) transition.large = true;
+			else for (auto& direction : rulesAnd.first)
+			{
+				if (direction != "ALL" && GetDirectionIndex(direction) == -1) shape.type = SHAPE_CUSTOM;
+			}
+
+			if (shape.type == SHAPE_CUSTOM)
+			{
+				transition.large = true;
+
+				for (auto& direction : rulesAnd.first)
+				{
+					int dx, dy;
+					if (GetOffset(direction, dx, dy)) shape.offsets.push_back({ dy, dx });
+				}
+
+				// sorted by rows, then swapped back to (dx, dy)
+				std::sort(shape.offsets.begin(), shape.offsets.end());
+				shape.offsets.erase(std::unique(shape.offsets.begin(), shape.offsets.end()), shape.offsets.end());
+
+				for (auto& offset : shape.offsets)
+				{
+					std::swap(offset.first, offset.second);
+					shape.key += std::to_string(offset.first) + "," + std::to_string(offset.second) + ";";
+				}
+			}
+
+			// directions that are not part of the neighborhood are never counted
+			ID_NEIGHBORS directions;
+			if (shape.type == SHAPE_NONE && rulesAnd.first.size() && rulesAnd.first[0] == "ALL") directions = allDirections;
+			else if (shape.type == SHAPE_NONE) for (auto& direction : rulesAnd.first)
+			{
+				if (neighbors.find(direction) == neighbors.end()) continue;
+
+				int d = GetDirectionIndex(direction);
+				if (d != -1) directions.push_back(d);
+			}
+
+			ID_CONDITIONS_OR idConditionsOr;
+			for (auto& conditionsOr : rulesAnd.second)
+			{
+				ID_CONDITIONS_AND idConditionsAnd;
+				for (auto& conditionsAnd : conditionsOr)
+				{
+					StateId id = Intern(conditionsAnd.second);
+					if (id == STATE_INVALID) resolved = false;
+
+					idConditionsAnd.push_back({ conditionsAnd.first, id });
+				}
+
+				idConditionsOr.push_back(idConditionsAnd);
+			}
+
+			int mask = 0;
+			for (int d : directions) mask |= 1 << d;
+
+			idRulesAnd.push_back({ directions, idConditionsOr });
+			masks.push_back(mask);
+			shapes.push_back(shape);
+		}
+
+		transition.idRules.push_back(idRulesAnd);
+		transition.idMasks.push_back(masks);
+		transition.idShapes.push_back(shapes);
+	}
+
+	return resolved;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+
+// compact integer representation of a state name
+typedef uint16_t StateId;
+
+#define STATE_FREE 0
+#define STATE_INVALID 0xFFFF
+
+struct Transition;
+
+class StateRegistry
+{
+public:
+	StateRegistry();
+	StateRegistry(const std::vector<std::string>& states);
+	~StateRegistry();
+
+	// STATE_INVALID once every id is taken
+	StateId Intern(const std::string& state);
+	StateId Find(const std::string& state) const;
+	const std::string& GetName(StateId id) const;
+	bool Rename(const std::string& oldState, const std::string& newState);
+
+	// its id is handed out again by the next Intern, so nothing may hold it anymore ("FREE" is never released)
+	void Release(const std::string& state);
+
+	// ids handed out so far, the released ones included (they have no name)
+	int Size() const;
+
+	// false if some state of the transition didn't get an id
+	bool Resolve(const std::string& state, Transition& transition, const std::unordered_set<std::string>& neighbors);
+private:
+	std::vector<std::string> m_Names;
+	std::unordered_map<std::string, StateId> m_Ids;
+
+	// released ids, the largest first
+	std::vector<StateId> m_Free;
+};
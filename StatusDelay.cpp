@@ -16,6 +16,62 @@ int StatusDelay::GetDelay()
     return m_Delays[m_Delay];
 }
 
+int StatusDelay::GetRenderEvery()
+{
+    return m_RenderEvery;
+}
+
+int StatusDelay::GetTargetSpeed()
+{
+    return m_TargetSpeed;
+}
+
+void StatusDelay::SetSpeed(double generationsPerSecond, int renderEvery)
+{
+    std::string speed = std::to_string(generationsPerSecond);
+    for (int i = speed.find('.') + 2; i < speed.size();) speed.pop_back();
+
+    m_TextSpeed->SetLabel("Gens/s=" + speed + " k=" + std::to_string(renderEvery));
+}
+
+bool StatusDelay::GetHashLife()
+{
+    return m_HashLife;
+}
+
+int StatusDelay::GetStep()
+{
+    return m_Step;
+}
+
+size_t StatusDelay::GetMemoryCap()
+{
+    return (size_t)m_MemoryCap << 20;
+}
+
+void StatusDelay::SetHashLifeInfo(size_t nodes, double hitRate)
+{
+    std::string hits = std::to_string(hitRate * 100);
+    for (int i = hits.find('.') + 2; i < hits.size();) hits.pop_back();
+
+    m_TextHashLife->SetLabel("Nodes=" + std::to_string(nodes) + " Hits=" + hits + "%");
+}
+
+bool StatusDelay::GetEndless()
+{
+    return m_Endless;
+}
+
+bool StatusDelay::GetStopOnCycle()
+{
+    return m_StopOnCycle;
+}
+
+void StatusDelay::SetTopology(int topology)
+{
+    m_ComboEdges->SetSelection(topology);
+}
+
 void StatusDelay::SetGrid(Grid* grid)
 {
     m_Grid = grid;
@@ -37,10 +93,73 @@ void StatusDelay::BuildInterface()
     std::string label = "Delay=" + delay;
     m_TextDelay = new wxStaticText(this, wxID_ANY, label);
 
+    m_SpinRender = new wxSpinCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize(64, -1), wxSP_ARROW_KEYS, 1, 100000, 1);
+    m_SpinRender->SetToolTip("Paint only every k-th generation");
+    m_SpinRender->Bind(wxEVT_SPINCTRL, &StatusDelay::ChangeRender, this);
+
+    m_CheckTarget = new wxCheckBox(this, wxID_ANY, "Target");
+    m_CheckTarget->SetToolTip("Run at this many generations per second, painting as often as the grid can keep up with\n(the delay and k are picked automatically)");
+    m_CheckTarget->Bind(wxEVT_CHECKBOX, &StatusDelay::ToggleTarget, this);
+
+    m_SpinTarget = new wxSpinCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize(80, -1), wxSP_ARROW_KEYS, 1, 10000000, 1000);
+    m_SpinTarget->SetToolTip("Target generations per second");
+    m_SpinTarget->Bind(wxEVT_SPINCTRL, &StatusDelay::ChangeTarget, this);
+
+    m_TextSpeed = new wxStaticText(this, wxID_ANY, "");
+
+    m_CheckHashLife = new wxCheckBox(this, wxID_ANY, "HashLife");
+    m_CheckHashLife->SetToolTip("Advance many generations at once on an endless plane\n(only for rules that count the neighbors, where \"FREE\" stays \"FREE\" around nothing)");
+    m_CheckHashLife->Bind(wxEVT_CHECKBOX, &StatusDelay::ToggleHashLife, this);
+
+    m_SpinStep = new wxSpinCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize(48, -1), wxSP_ARROW_KEYS, 0, 20, 0);
+    m_SpinStep->SetToolTip("Generations per step = 2^n");
+    m_SpinStep->Bind(wxEVT_SPINCTRL, &StatusDelay::ChangeStep, this);
+
+    m_SpinMemory = new wxSpinCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize(64, -1), wxSP_ARROW_KEYS, 16, 16384, m_MemoryCap);
+    m_SpinMemory->SetToolTip("Memory cap of HashLife's nodes (MB)");
+    m_SpinMemory->Bind(wxEVT_SPINCTRL, &StatusDelay::ChangeMemory, this);
+
+    m_TextHashLife = new wxStaticText(this, wxID_ANY, "");
+
+    m_CheckEndless = new wxCheckBox(this, wxID_ANY, "Endless");
+    m_CheckEndless->SetToolTip("Cells that leave the grid keep living outside of it\n(same rules as HashLife)");
+    m_CheckEndless->Bind(wxEVT_CHECKBOX, &StatusDelay::ToggleEndless, this);
+
+    m_CheckCycles = new wxCheckBox(this, wxID_ANY, "Stop on cycles");
+    m_CheckCycles->SetToolTip("Pause as soon as the cells repeat themselves\n(periods of up to 1024 generations)");
+    m_CheckCycles->Bind(wxEVT_CHECKBOX, &StatusDelay::ToggleCycles, this);
+
+    // same order as Topology.h
+    m_ComboEdges = new wxComboBox(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, {}, wxCB_READONLY | wxCB_DROPDOWN);
+    m_ComboEdges->Set({ "Bounded", "Torus", "Klein bottle", "Mirror", "Border" });
+    m_ComboEdges->SetSelection(TOPOLOGY_BOUNDED);
+    m_ComboEdges->SetToolTip("What the cells on the edges see past them\n(the border is made of cells of the selected state; HashLife and Endless need bounded edges)");
+    m_ComboEdges->Bind(wxEVT_COMBOBOX, &StatusDelay::ChangeEdges, this);
+
     wxBoxSizer* sizer = new wxBoxSizer(wxHORIZONTAL);
     sizer->Add(slower, 0, wxALIGN_CENTER_VERTICAL);
     sizer->Add(faster, 0, wxALIGN_CENTER_VERTICAL);
     sizer->Add(m_TextDelay, 0, wxALIGN_CENTER_VERTICAL);
+    sizer->AddSpacer(8);
+    sizer->Add(m_SpinRender, 0, wxALIGN_CENTER_VERTICAL);
+    sizer->AddSpacer(8);
+    sizer->Add(m_CheckTarget, 0, wxALIGN_CENTER_VERTICAL);
+    sizer->Add(m_SpinTarget, 0, wxALIGN_CENTER_VERTICAL);
+    sizer->AddSpacer(4);
+    sizer->Add(m_TextSpeed, 0, wxALIGN_CENTER_VERTICAL);
+    sizer->AddSpacer(16);
+    sizer->Add(m_CheckHashLife, 0, wxALIGN_CENTER_VERTICAL);
+    sizer->Add(m_SpinStep, 0, wxALIGN_CENTER_VERTICAL);
+    sizer->Add(m_SpinMemory, 0, wxALIGN_CENTER_VERTICAL);
+    sizer->AddSpacer(4);
+    sizer->Add(m_TextHashLife, 0, wxALIGN_CENTER_VERTICAL);
+    sizer->AddSpacer(16);
+    sizer->Add(m_CheckEndless, 0, wxALIGN_CENTER_VERTICAL);
+    sizer->AddSpacer(8);
+    sizer->Add(m_CheckCycles, 0, wxALIGN_CENTER_VERTICAL);
+    sizer->AddSpacer(8);
+    sizer->Add(new wxStaticText(this, wxID_ANY, "Edges:"), 0, wxALIGN_CENTER_VERTICAL);
+    sizer->Add(m_ComboEdges, 0, wxALIGN_CENTER_VERTICAL);
     sizer->AddSpacer(24);
 
     SetSizer(sizer);
@@ -60,7 +179,7 @@ void StatusDelay::IncreaseDelay(wxCommandEvent& evt)
 {
     m_Grid->SetFocus();
 
-    if (m_Delay == 4) return;
+    if (m_Delay == 5) return;
 
     m_Delay++;
 
@@ -76,4 +195,64 @@ void StatusDelay::DecreaseDelay(wxCommandEvent& evt)
     m_Delay--;
 
     UpdateTextDelay();
+}
+
+void StatusDelay::ToggleHashLife(wxCommandEvent& evt)
+{
+    m_HashLife = m_CheckHashLife->GetValue();
+
+    if (!m_HashLife) m_TextHashLife->SetLabel("");
+
+    m_Grid->SetFocus();
+}
+
+void StatusDelay::ChangeStep(wxSpinEvent& evt)
+{
+    m_Step = m_SpinStep->GetValue();
+}
+
+void StatusDelay::ChangeMemory(wxSpinEvent& evt)
+{
+    m_MemoryCap = m_SpinMemory->GetValue();
+}
+
+void StatusDelay::ToggleEndless(wxCommandEvent& evt)
+{
+    m_Endless = m_CheckEndless->GetValue();
+
+    m_Grid->SetFocus();
+}
+
+void StatusDelay::ToggleCycles(wxCommandEvent& evt)
+{
+    m_StopOnCycle = m_CheckCycles->GetValue();
+
+    m_Grid->SetFocus();
+}
+
+void StatusDelay::ChangeRender(wxSpinEvent& evt)
+{
+    m_RenderEvery = m_SpinRender->GetValue();
+}
+
+void StatusDelay::ToggleTarget(wxCommandEvent& evt)
+{
+    m_TargetSpeed = m_CheckTarget->GetValue() ? m_SpinTarget->GetValue() : 0;
+
+    // k is picked by the grid now
+    m_SpinRender->Enable(!m_TargetSpeed);
+
+    m_Grid->SetFocus();
+}
+
+void StatusDelay::ChangeTarget(wxSpinEvent& evt)
+{
+    if (m_TargetSpeed) m_TargetSpeed = m_SpinTarget->GetValue();
+}
+
+void StatusDelay::ChangeEdges(wxCommandEvent& evt)
+{
+    m_Grid->SetTopology(m_ComboEdges->GetSelection());
+
+    m_Grid->SetFocus();
 }
\ No newline at end of file
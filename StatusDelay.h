@@ -1,5 +1,6 @@
 #pragma once
 #include "wx/wx.h"
+#include "wx/spinctrl.h"
 
 #include "Ids.h"
 #include "Grid.h"
@@ -13,20 +14,72 @@ public:
 	~StatusDelay();
 
 	int GetDelay();
+
+	// only every k-th generation is painted; with a target speed (generations per second, 0 = none)
+	// the grid picks k by itself and the delay is ignored
+	int GetRenderEvery();
+	int GetTargetSpeed();
+	void SetSpeed(double generationsPerSecond, int renderEvery);
+
+	// HashLife: advance 2^step generations at once, collect its nodes past the memory cap
+	bool GetHashLife();
+	int GetStep();
+	size_t GetMemoryCap();
+	void SetHashLifeInfo(size_t nodes, double hitRate);
+
+	// cells that leave the grid keep living on an endless plane
+	bool GetEndless();
+
+	// pause as soon as the cells start repeating themselves
+	bool GetStopOnCycle();
+
+	// what the cells on the edges see past them (see Topology.h)
+	void SetTopology(int topology);
 	
 	void SetGrid(Grid* grid);
 private:
 	Grid* m_Grid = nullptr;
 
-	int m_Delay = 0;
-	int m_Delays[5] = { 100, 250, 500, 1000, 2000 };
+	// 0 = as fast as the generations can be computed, the grid is painted in between
+	int m_Delay = 1;
+	int m_Delays[6] = { 0, 100, 250, 500, 1000, 2000 };
 
 	wxStaticText* m_TextDelay = nullptr;
+	wxStaticText* m_TextSpeed = nullptr;
+
+	// read by the generating thread, so they're kept apart from the controls
+	bool m_HashLife = false;
+	int m_Step = 0;
+	int m_MemoryCap = 512;
+	bool m_Endless = false;
+	bool m_StopOnCycle = false;
+	int m_RenderEvery = 1;
+	int m_TargetSpeed = 0;
+
+	wxCheckBox* m_CheckHashLife = nullptr;
+	wxSpinCtrl* m_SpinStep = nullptr;
+	wxSpinCtrl* m_SpinMemory = nullptr;
+	wxStaticText* m_TextHashLife = nullptr;
+	wxCheckBox* m_CheckEndless = nullptr;
+	wxCheckBox* m_CheckCycles = nullptr;
+	wxSpinCtrl* m_SpinRender = nullptr;
+	wxCheckBox* m_CheckTarget = nullptr;
+	wxSpinCtrl* m_SpinTarget = nullptr;
+	wxComboBox* m_ComboEdges = nullptr;
 
 	void BuildInterface();
 	void UpdateTextDelay();
 
 	void IncreaseDelay(wxCommandEvent& evt);
 	void DecreaseDelay(wxCommandEvent& evt);
+	void ToggleHashLife(wxCommandEvent& evt);
+	void ChangeStep(wxSpinEvent& evt);
+	void ChangeMemory(wxSpinEvent& evt);
+	void ToggleEndless(wxCommandEvent& evt);
+	void ToggleCycles(wxCommandEvent& evt);
+	void ChangeRender(wxSpinEvent& evt);
+	void ToggleTarget(wxCommandEvent& evt);
+	void ChangeTarget(wxSpinEvent& evt);
+	void ChangeEdges(wxCommandEvent& evt);
 };
 
@@ -0,0 +1,107 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(int nThreads)
+{
+	if (nThreads <= 0) nThreads = std::thread::hardware_concurrency();
+	if (nThreads <= 0) nThreads = 1;
+
+	for (int i = 0; i < nThreads; i++) m_Threads.push_back(std::thread(&ThreadPool::Work, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+	m_Mutex.lock();
+	m_Stop = true;
+	m_Mutex.unlock();
+
+	m_Wake.notify_all();
+
+	for (auto& thread : m_Threads) thread.join();
+}
+
+int ThreadPool::GetSize()
+{
+	return m_Threads.size();
+}
+
+void ThreadPool::Post(std::function<void()> job)
+{
+	m_Mutex.lock();
+	m_Jobs.push_back(job);
+	m_Mutex.unlock();
+
+	m_Wake.notify_one();
+}
+
+void ThreadPool::For(int n, std::function<void(int)> task)
+{
+	if (n <= 0) return;
+
+	std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+	batch->task = task;
+	batch->n = n;
+
+	// the other threads help out if they're free, the calling thread
+	// takes whatever is left, so this works from inside a job as well
+	int helpers = std::min<int>(n - 1, m_Threads.size());
+
+	m_Mutex.lock();
+	for (int i = 0; i < helpers; i++) m_Jobs.push_back(std::bind(&ThreadPool::RunShared, this, batch));
+	m_Mutex.unlock();
+
+	if (helpers == 1) m_Wake.notify_one();
+	else if (helpers) m_Wake.notify_all();
+
+	RunBatch(*batch);
+
+	// wait for the tasks other threads are still working on
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_Done.wait(lock, [&batch] { return batch->done == batch->n; });
+}
+
+void ThreadPool::Work()
+{
+	while (true)
+	{
+		std::function<void()> job;
+
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Wake.wait(lock, [this] { return m_Stop || m_Jobs.size(); });
+
+			if (m_Stop && m_Jobs.empty()) return;
+
+			job = m_Jobs.front();
+			m_Jobs.pop_front();
+		}
+
+		job();
+	}
+}
+
+void ThreadPool::RunShared(std::shared_ptr<Batch> batch)
+{
+	// helpers that start late find nothing left to do and only release the batch
+	RunBatch(*batch);
+}
+
+void ThreadPool::RunBatch(Batch& batch)
+{
+	while (true)
+	{
+		int i = batch.next++;
+		if (i >= batch.n) return;
+
+		batch.task(i);
+
+		if (++batch.done == batch.n)
+		{
+			m_Mutex.lock();
+			m_Mutex.unlock();
+
+			m_Done.notify_all();
+		}
+	}
+}
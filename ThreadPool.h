@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+
+// threads that live as long as the pool, instead of one new thread for every generation
+class ThreadPool
+{
+public:
+	// 0 threads = one for every hardware thread
+	ThreadPool(int nThreads = 0);
+	~ThreadPool();
+
+	int GetSize();
+
+	// runs the job on one of the threads and returns right away
+	void Post(std::function<void()> job);
+
+	// runs task(0), ..., task(n - 1) on all threads (the calling one included) and waits for them
+	void For(int n, std::function<void(int)> task);
+private:
+	// tasks of one For() call
+	struct Batch
+	{
+		std::function<void(int)> task;
+		int n = 0;
+		std::atomic<int> next{ 0 };
+		std::atomic<int> done{ 0 };
+	};
+
+	std::vector<std::thread> m_Threads;
+	std::deque<std::function<void()>> m_Jobs;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_Wake;
+	std::condition_variable m_Done;
+	bool m_Stop = false;
+
+	void Work();
+	void RunShared(std::shared_ptr<Batch> batch);
+	void RunBatch(Batch& batch);
+};
@@ -4,6 +4,8 @@
 #include "Ids.h"
 #include "Sizes.h"
 #include "Hashes.h"
+#include "StateRegistry.h"
+#include "Universe.h"
 #include "Grid.h"
 
 #include <deque>
@@ -19,21 +21,14 @@ public:
 
 	void SetGrid(Grid* grid);
 
-	void PushBack(
-		std::unordered_map<std::pair<int, int>, std::pair<std::string, wxColour>, Hashes::PairInt>& cells,
-		std::unordered_map<std::string, std::unordered_set<std::pair<int, int>, Hashes::PairInt>>& statePositions,
-		std::unordered_map<std::pair<int, int>, std::pair<std::string, wxColour>, Hashes::PairInt>& prevCells,
-		std::unordered_map<std::string, std::unordered_set<std::pair<int, int>, Hashes::PairInt>>& prevStatePositions
-	);
+	void PushBack(std::vector<Change> changes);
 
 	void Reset();
 private:
 	Grid* m_Grid = nullptr;
 
-	std::deque<std::vector<std::pair<std::pair<int, int>, std::pair<std::string, wxColour>>>> m_UndoCells;
-	std::deque<std::vector<std::pair<std::pair<int, int>, std::pair<std::string, wxColour>>>> m_RedoCells;
-	std::deque<std::vector<std::pair<std::string, std::pair<int, int>>>> m_UndoStatePositions;
-	std::deque<std::vector<std::pair<std::string, std::pair<int, int>>>> m_RedoStatePositions;
+	std::deque<std::vector<Change>> m_UndoCells;
+	std::deque<std::vector<Change>> m_RedoCells;
 
 	wxBitmapButton* m_Undo = nullptr;
 	wxBitmapButton* m_Redo = nullptr;
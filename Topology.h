@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+
+// what the cells on the edges of the universe see past them
+#define TOPOLOGY_BOUNDED 0 // nothing, out of bounds cells don't match any state
+#define TOPOLOGY_TORUS 1 // the opposite edge
+#define TOPOLOGY_KLEIN 2 // the opposite edge, mirrored when crossing the top or the bottom edge
+#define TOPOLOGY_MIRROR 3 // the cells on this side of the edge, as in a mirror
+#define TOPOLOGY_BORDER 4 // cells of one fixed state all around
+
+#define N_TOPOLOGIES 5
+
+// names used by "[SIZE]", e.g. "100 100 TORUS" or "100 100 BORDER <state>"
+const std::string TOPOLOGY_NAMES[N_TOPOLOGIES] = { "BOUNDED", "TORUS", "KLEIN", "MIRROR", "BORDER" };
+
+inline int GetTopologyIndex(const std::string& topology)
+{
+	for (int t = 0; t < N_TOPOLOGIES; t++)
+	{
+		if (TOPOLOGY_NAMES[t] == topology) return t;
+	}
+
+	return -1;
+}
@@ -4,6 +4,9 @@
 #include <vector>
 #include <string>
 
+#include "StateRegistry.h"
+#include "Shape.h"
+
 #define TYPE_EQUAL 0
 #define TYPE_LESS -1
 #define TYPE_MORE 1
@@ -16,8 +19,32 @@
 #define RULES_AND vector<pair<NEIGHBORS, CONDITIONS_OR>> // pair = (<neighborhood>, ...)
 #define RULES_OR vector<RULES_AND>
 
+// same as above, but with state names interned and directions as indexes
+#define ID_CONDITIONS_AND vector<pair<pair<int, int>, StateId>> // pair = ((<number-of-cells>, <comparison-type>), <state id>)
+#define ID_CONDITIONS_OR vector<ID_CONDITIONS_AND>
+#define ID_NEIGHBORS vector<int>
+#define ID_STATES vector<StateId>
+#define ID_RULES_AND vector<pair<ID_NEIGHBORS, ID_CONDITIONS_OR>>
+#define ID_RULES_OR vector<ID_RULES_AND>
+
+#define N_DIRECTIONS 9
+
 using namespace std;
 
+const string DIRECTION_NAMES[N_DIRECTIONS] = { "NW", "N", "NE", "W", "C", "E", "SW", "S", "SE" };
+const int DIRECTION_DX[N_DIRECTIONS] = { -1, 0, 1, -1, 0, 1, -1, 0, 1 };
+const int DIRECTION_DY[N_DIRECTIONS] = { -1, -1, -1, 0, 0, 0, 1, 1, 1 };
+
+inline int GetDirectionIndex(const string& direction)
+{
+	for (int d = 0; d < N_DIRECTIONS; d++)
+	{
+		if (DIRECTION_NAMES[d] == direction) return d;
+	}
+
+	return -1;
+}
+
 struct Transition
 {
 	string state;
@@ -26,10 +53,23 @@ struct Transition
 
 	STATES states;
 	DIRECTIONS directions;
-	
+
 	CONDITIONS_AND andConditions;
 	CONDITIONS_OR orConditions;
 
 	RULES_AND andRules;
 	RULES_OR orRules;
+
+	// filled in by StateRegistry::Resolve
+	StateId fromId = STATE_INVALID;
+	StateId stateId = STATE_INVALID;
+	ID_STATES stateIds;
+	ID_RULES_OR idRules;
+
+	// bits of the directions counted by every "AND" rule of idRules (bit d = direction d)
+	vector<vector<int>> idMasks;
+
+	// neighborhood of every "AND" rule of idRules when it's larger than the directions (SHAPE_NONE otherwise)
+	vector<vector<Shape>> idShapes;
+	bool large = false;
 };
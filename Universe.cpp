@@ -0,0 +1,397 @@
+#include "Universe.h"
+
+#include <algorithm>
+
+Universe::Universe(int rows, int cols)
+{
+	Resize(rows, cols);
+}
+
+Universe::~Universe()
+{
+}
+
+void Universe::Resize(int rows, int cols)
+{
+	m_Rows = rows;
+	m_Cols = cols;
+
+	Clear();
+}
+
+void Universe::Clear()
+{
+	const int N = m_Rows * m_Cols;
+
+	m_Front.assign(N, STATE_FREE);
+	m_Back.assign(N, STATE_FREE);
+	m_Padded.assign((m_Rows + 2) * (m_Cols + 2), STATE_FREE);
+
+	m_Counts.assign(1, N);
+
+	m_Hash = 0;
+	m_CommitHash = 0;
+
+	m_Dirty.clear();
+	m_DirtyMark.assign(N, false);
+	m_AllDirty = false;
+
+	m_Indexed = false;
+	m_Positions.clear();
+	m_Slots.clear();
+
+	m_Version++;
+}
+
+int Universe::GetRows() const
+{
+	return m_Rows;
+}
+
+int Universe::GetCols() const
+{
+	return m_Cols;
+}
+
+int Universe::GetSize() const
+{
+	return m_Rows * m_Cols;
+}
+
+int Universe::GetPopulation() const
+{
+	return m_Rows * m_Cols - m_Counts[STATE_FREE];
+}
+
+int Universe::CountState(StateId state) const
+{
+	if (state >= m_Counts.size()) return 0;
+
+	return m_Counts[state];
+}
+
+int Universe::GetStateCount() const
+{
+	// ids of all states that have ever been on the cells are below this
+	return m_Counts.size();
+}
+
+unsigned long long Universe::GetVersion() const
+{
+	return m_Version;
+}
+
+unsigned long long Universe::GetHash() const
+{
+	return m_Hash;
+}
+
+void Universe::SetTopology(int topology, StateId border)
+{
+	if (topology == m_Topology && border == m_Border) return;
+
+	m_Topology = topology;
+	m_Border = border;
+
+	// the cells stay the same, but everything that depends on their neighbors is out of date
+	m_Version++;
+}
+
+int Universe::GetTopology() const
+{
+	return m_Topology;
+}
+
+StateId Universe::GetBorder() const
+{
+	return m_Border;
+}
+
+void Universe::RefreshGhosts()
+{
+	if (m_GhostsVersion == m_Version) return;
+
+	const int P = m_Cols + 2;
+
+	// only the first and last row and column of the padded cells
+	for (int y = -1; y <= m_Rows; y++)
+	{
+		int step = (y == -1 || y == m_Rows) ? 1 : m_Cols + 1;
+
+		for (int x = -1; x <= m_Cols; x += step) m_Padded[(y + 1) * P + x + 1] = GetWrapped(x, y);
+	}
+
+	m_GhostsVersion = m_Version;
+}
+
+int Universe::Map(int x, int y, int rows, int cols, int topology)
+{
+	if (x >= 0 && x < cols && y >= 0 && y < rows) return y * cols + x;
+
+	switch (topology)
+	{
+	case TOPOLOGY_TORUS:
+	case TOPOLOGY_KLEIN:
+	{
+		// how many times the top or the bottom edge was crossed; every crossing mirrors a klein bottle
+		int turns = y >= 0 ? y / rows : (y + 1) / rows - 1;
+		y -= turns * rows;
+
+		if (topology == TOPOLOGY_KLEIN && turns % 2) x = cols - 1 - x;
+		x = (x % cols + cols) % cols;
+
+		return y * cols + x;
+	}
+	case TOPOLOGY_MIRROR:
+	{
+		// the edge itself is the first cell behind the mirror
+		x = (x % (2 * cols) + 2 * cols) % (2 * cols);
+		y = (y % (2 * rows) + 2 * rows) % (2 * rows);
+
+		if (x >= cols) x = 2 * cols - 1 - x;
+		if (y >= rows) y = 2 * rows - 1 - y;
+
+		return y * cols + x;
+	}
+	default:
+		return -1;
+	}
+}
+
+StateId Universe::GetWrapped(int x, int y) const
+{
+	int k = Map(x, y);
+	if (k != -1) return m_Front[k];
+
+	// out of bounds cells don't match any state, unless there's a border
+	return m_Topology == TOPOLOGY_BORDER ? m_Border : STATE_INVALID;
+}
+
+bool Universe::Set(int k, StateId state)
+{
+	StateId prev = m_Front[k];
+	if (prev == state) return false;
+
+	m_Front[k] = state;
+	m_Padded[Pad(k)] = state;
+	m_Version++;
+
+	m_Hash ^= Zobrist(k, prev) ^ Zobrist(k, state);
+
+	Count(prev, -1);
+	Count(state, +1);
+
+	if (m_Indexed)
+	{
+		IndexErase(k, prev);
+		IndexInsert(k, state);
+	}
+
+	if (!m_DirtyMark[k])
+	{
+		m_DirtyMark[k] = true;
+		m_Dirty.push_back(k);
+	}
+
+	return true;
+}
+
+const std::vector<int>& Universe::GetPositions(StateId state)
+{
+	static const std::vector<int> none;
+
+	if (!m_Indexed) BuildIndex();
+
+	if (state == STATE_FREE || state >= m_Positions.size()) return none;
+
+	return m_Positions[state];
+}
+
+void Universe::BuildBands(int bandRows)
+{
+	bandRows = std::max(1, bandRows);
+
+	// nothing changed since the last time
+	if (m_Bands.size() && bandRows == m_BandRows && m_BandsVersion == m_Version) return;
+
+	if (!m_Indexed) BuildIndex();
+
+	m_BandRows = bandRows;
+	m_BandsVersion = m_Version;
+
+	const int nBands = (m_Rows + bandRows - 1) / bandRows;
+
+	m_Bands.assign(m_Positions.size(), std::vector<std::vector<int>>(nBands));
+	for (int state = 0; state < m_Positions.size(); state++)
+	{
+		for (int k : m_Positions[state]) m_Bands[state][k / m_Cols / bandRows].push_back(k);
+	}
+}
+
+int Universe::GetBands() const
+{
+	if (m_BandRows == 0) return 0;
+
+	return (m_Rows + m_BandRows - 1) / m_BandRows;
+}
+
+int Universe::GetBandRows() const
+{
+	return m_BandRows;
+}
+
+const std::vector<int>& Universe::GetBand(StateId state, int band) const
+{
+	static const std::vector<int> none;
+
+	if (state == STATE_FREE || state >= m_Bands.size() || band < 0 || band >= m_Bands[state].size()) return none;
+
+	return m_Bands[state][band];
+}
+
+std::vector<int> Universe::GetBandsAround(int band) const
+{
+	std::vector<int> bands;
+
+	const int nBands = GetBands();
+	bool wraps = nBands && (m_Topology == TOPOLOGY_TORUS || m_Topology == TOPOLOGY_KLEIN);
+
+	for (int b = band - 1; b <= band + 1; b++)
+	{
+		int around = b;
+		if (wraps) around = (b + nBands) % nBands;
+
+		if (around < 0 || around >= nBands || std::find(bands.begin(), bands.end(), around) != bands.end()) continue;
+
+		bands.push_back(around);
+	}
+
+	return bands;
+}
+
+StateId* Universe::GetNext()
+{
+	return m_Back.data();
+}
+
+void Universe::Swap()
+{
+	// the previous generation becomes the back buffer
+	std::swap(m_Front, m_Back);
+	m_Version++;
+
+	const int N = m_Rows * m_Cols;
+
+	std::fill(m_Counts.begin(), m_Counts.end(), 0);
+	m_Hash = 0;
+
+	for (int k = 0; k < N; k++)
+	{
+		Count(m_Front[k], +1);
+		m_Hash ^= Zobrist(k, m_Front[k]);
+		m_Padded[Pad(k)] = m_Front[k];
+	}
+
+	if (m_Indexed) BuildIndex();
+
+	m_AllDirty = true;
+}
+
+bool Universe::Changed()
+{
+	return m_Hash != m_CommitHash;
+}
+
+std::vector<Change> Universe::GetChanges()
+{
+	std::vector<Change> changes;
+
+	if (m_AllDirty)
+	{
+		const int N = m_Rows * m_Cols;
+
+		for (int k = 0; k < N; k++)
+		{
+			if (m_Front[k] != m_Back[k]) changes.push_back({ k, m_Back[k], m_Front[k] });
+		}
+	}
+	else
+	{
+		for (int k : m_Dirty)
+		{
+			if (m_Front[k] != m_Back[k]) changes.push_back({ k, m_Back[k], m_Front[k] });
+		}
+	}
+
+	return changes;
+}
+
+void Universe::Commit()
+{
+	// only the cells that might have changed need to be copied
+	if (m_AllDirty) m_Back = m_Front;
+	else for (int k : m_Dirty) m_Back[k] = m_Front[k];
+
+	for (int k : m_Dirty) m_DirtyMark[k] = false;
+	m_Dirty.clear();
+	m_AllDirty = false;
+
+	m_CommitHash = m_Hash;
+}
+
+void Universe::Count(StateId state, int delta)
+{
+	if (state >= m_Counts.size()) m_Counts.resize(state + 1, 0);
+
+	m_Counts[state] += delta;
+}
+
+unsigned long long Universe::Zobrist(int k, StateId state)
+{
+	if (state == STATE_FREE) return 0;
+
+	// a random key for every (position, state), without keeping a table of them
+	unsigned long long z = ((unsigned long long)k << 16 | state) + 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+	return z ^ (z >> 31);
+}
+
+void Universe::BuildIndex()
+{
+	const int N = m_Rows * m_Cols;
+
+	m_Positions.assign(m_Counts.size(), std::vector<int>());
+	m_Slots.assign(N, -1);
+
+	for (int k = 0; k < N; k++) IndexInsert(k, m_Front[k]);
+
+	m_Indexed = true;
+}
+
+void Universe::IndexInsert(int k, StateId state)
+{
+	if (state == STATE_FREE) return;
+
+	if (state >= m_Positions.size()) m_Positions.resize(state + 1);
+
+	m_Slots[k] = m_Positions[state].size();
+	m_Positions[state].push_back(k);
+}
+
+void Universe::IndexErase(int k, StateId state)
+{
+	if (state == STATE_FREE) return;
+
+	// move the last position into the freed slot
+	std::vector<int>& positions = m_Positions[state];
+	int slot = m_Slots[k];
+	int last = positions.back();
+
+	positions[slot] = last;
+	m_Slots[last] = slot;
+	positions.pop_back();
+
+	m_Slots[k] = -1;
+}
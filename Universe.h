@@ -0,0 +1,133 @@
+#pragma once
+#include <vector>
+#include <utility>
+
+#include "StateRegistry.h"
+#include "Topology.h"
+
+// one cell that changed its state; kept as small as possible, a generation can have millions of them
+struct Change
+{
+	int cell;
+	StateId from;
+	StateId to;
+};
+
+// flat rows*cols array of state ids, with a second buffer holding
+// the previous generation (also used as the undo snapshot) and a third
+// one with a border of "ghost" cells around them (see Topology.h)
+class Universe
+{
+public:
+	Universe(int rows = 0, int cols = 0);
+	~Universe();
+
+	void Resize(int rows, int cols);
+	void Clear();
+
+	int GetRows() const;
+	int GetCols() const;
+	int GetSize() const;
+	int GetPopulation() const;
+	int CountState(StateId state) const;
+	int GetStateCount() const;
+	unsigned long long GetVersion() const;
+
+	// zobrist hash of the current cells, updated with every change ("FREE" cells add nothing)
+	unsigned long long GetHash() const;
+
+	// what the cells on the edges see past them; border = state of the cells around, for TOPOLOGY_BORDER
+	void SetTopology(int topology, StateId border = STATE_FREE);
+	int GetTopology() const;
+	StateId GetBorder() const;
+
+	// is there a border of cells of this state around the universe?
+	inline bool IsBorder(StateId state) const { return m_Topology == TOPOLOGY_BORDER && m_Border == state; }
+
+	// the cells with a border of one ghost cell, so neighbors can be read without checking the edges;
+	// (x, y) is at (y + 1) * GetPaddedCols() + x + 1 and the ghosts are only right after RefreshGhosts()
+	inline const StateId* GetPadded() const { return m_Padded.data(); }
+	inline int GetPaddedCols() const { return m_Cols + 2; }
+	void RefreshGhosts();
+
+	// position of the cell seen at (x, y), which can be outside of the universe; -1 if there's no cell there
+	inline int Map(int x, int y) const { return Map(x, y, m_Rows, m_Cols, m_Topology); }
+	static int Map(int x, int y, int rows, int cols, int topology);
+
+	// state seen at (x, y), without going through the ghosts
+	StateId GetWrapped(int x, int y) const;
+
+	inline StateId Get(int k) const { return m_Front[k]; }
+	inline StateId Get(int x, int y) const { return m_Front[y * m_Cols + x]; }
+	inline StateId GetPrev(int k) const { return m_Back[k]; }
+	inline const StateId* GetCells() const { return m_Front.data(); }
+
+	bool Set(int k, StateId state);
+	inline bool Set(int x, int y, StateId state) { return Set(y * m_Cols + x, state); }
+
+	// positions of the cells of a state ("FREE" cells aren't indexed)
+	const std::vector<int>& GetPositions(StateId state);
+
+	// same positions split into bands of rows, so every band can be handled by another thread;
+	// GetBand() only reads, the bands have to be built before
+	void BuildBands(int bandRows);
+	int GetBands() const;
+	int GetBandRows() const;
+	const std::vector<int>& GetBand(StateId state, int band) const;
+
+	// bands with cells that can be neighbors of the cells in this band (the first and the last one are next to each other, if the edges wrap)
+	std::vector<int> GetBandsAround(int band) const;
+
+	// full-buffer kernels write the next generation here and then swap
+	StateId* GetNext();
+	void Swap();
+
+	// differences between the current cells and the last commit (Changed() only compares hashes)
+	bool Changed();
+	std::vector<Change> GetChanges();
+	void Commit();
+private:
+	int m_Rows = 0;
+	int m_Cols = 0;
+
+	std::vector<StateId> m_Front;
+	std::vector<StateId> m_Back;
+	std::vector<StateId> m_Padded;
+	std::vector<int> m_Counts;
+
+	int m_Topology = TOPOLOGY_BOUNDED;
+	StateId m_Border = STATE_FREE;
+
+	// version of the cells the ghosts were refreshed for
+	unsigned long long m_GhostsVersion = 0;
+
+	// increases with every modification, so copies of the cells know when they're stale
+	unsigned long long m_Version = 0;
+
+	// hash of the front buffer and the hash it had at the last commit
+	unsigned long long m_Hash = 0;
+	unsigned long long m_CommitHash = 0;
+
+	// cells that might differ between the two buffers
+	std::vector<int> m_Dirty;
+	std::vector<char> m_DirtyMark;
+	bool m_AllDirty = false;
+
+	// per-state index, only maintained after someone asked for it
+	bool m_Indexed = false;
+	std::vector<std::vector<int>> m_Positions;
+	std::vector<int> m_Slots;
+
+	// indexed by state, then by band
+	int m_BandRows = 0;
+	unsigned long long m_BandsVersion = 0;
+	std::vector<std::vector<std::vector<int>>> m_Bands;
+
+	inline int Pad(int k) const { return k + m_Cols + 3 + 2 * (k / m_Cols); }
+
+	void Count(StateId state, int delta);
+	static unsigned long long Zobrist(int k, StateId state);
+	void BuildIndex();
+	void IndexInsert(int k, StateId state);
+	void IndexErase(int k, StateId state);
+};
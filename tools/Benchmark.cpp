@@ -0,0 +1,172 @@
+// runs every pattern of a directory on a few grid sizes and densities and prints the results as JSON:
+//     Benchmark <patterns directory> [generations] [threads]
+// built like Headless.cpp; the cells are seeded with a fixed seed, so every run starts the same;
+// only the rule engine is timed, putting its changes into the cells isn't
+
+#include "../Automaton.h"
+#include "../PatternFile.h"
+
+#include <cstdio>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// peak resident memory of the process so far, in KB
+long long GetPeakMemory()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+
+	return counters.PeakWorkingSetSize / 1024;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage)) return 0;
+
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+double GetPercentile(std::vector<double>& sorted, double percentile)
+{
+	if (sorted.empty()) return 0;
+
+	int i = std::min<int>(sorted.size() - 1, percentile * sorted.size());
+
+	return sorted[i];
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "Usage: %s <patterns directory> [generations] [threads]\n", argv[0]);
+		return 1;
+	}
+
+	int generations = argc > 2 ? std::stoi(argv[2]) : 100;
+	int threads = argc > 3 ? std::stoi(argv[3]) : 0;
+
+	const int sizes[] = { 101, 512, 2048 };
+
+	// -1 = the cells of the pattern file
+	const double densities[] = { -1, 0.1, 0.3, 0.5 };
+
+	std::vector<std::filesystem::path> files;
+	for (auto& entry : std::filesystem::directory_iterator(argv[1]))
+	{
+		if (entry.path().extension() == ".txt") files.push_back(entry.path());
+	}
+	std::sort(files.begin(), files.end());
+
+	Automaton automaton(threads);
+	std::vector<Change> changes;
+
+	std::printf("{\n\t\"generations\": %d,\n\t\"runs\": [", generations);
+	bool first = true;
+
+	for (auto& file : files)
+	{
+		std::ifstream in(file, std::ios::binary);
+		std::stringstream text;
+		text << in.rdbuf();
+
+		auto read = PatternFile::Read(text.str());
+		if (read.second.size())
+		{
+			std::fprintf(stderr, "%s: line %d: %s\n", file.string().c_str(), read.second.front().first, read.second.front().second.c_str());
+			continue;
+		}
+
+		for (int size : sizes)
+		{
+			for (double density : densities)
+			{
+				PatternFile::Pattern pattern = read.first;
+				pattern.rows = size;
+				pattern.cols = size;
+
+				std::string error = automaton.Load(pattern);
+				if (error.size())
+				{
+					std::fprintf(stderr, "%s: %s\n", file.string().c_str(), error.c_str());
+					break;
+				}
+
+				if (density >= 0) automaton.Populate(density, 1);
+
+				Universe& cells = automaton.GetCells();
+				int population = cells.GetPopulation();
+
+				const RuleSet& ruleSet = automaton.GetRuleSet();
+				RuleEngine& engine = automaton.GetEngine();
+				ThreadPool& pool = automaton.GetThreadPool();
+
+				std::vector<double> latencies;
+				latencies.reserve(generations);
+
+				for (int generation = 0; generation < generations; generation++)
+				{
+					// same bands as the grid
+					auto start = std::chrono::steady_clock::now();
+					engine.Step(ruleSet, cells, pool, pool.GetSize() * 4, changes);
+					double latency = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+					for (auto& change : changes) cells.Set(change.cell, change.to);
+					cells.Commit();
+
+					// the neighbor counts and the active cells follow the changes
+					start = std::chrono::steady_clock::now();
+					engine.Commit(changes, cells);
+					latency += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+					latencies.push_back(latency);
+
+					// universe has come to an end
+					if (changes.empty()) break;
+				}
+
+				double seconds = 0;
+				for (double latency : latencies) seconds += latency * 1e-6;
+
+				std::sort(latencies.begin(), latencies.end());
+
+				double perSecond = seconds > 0 ? latencies.size() / seconds : 0;
+
+				std::printf(first ? "\n" : ",\n");
+				first = false;
+
+				std::printf("\t\t{ \"pattern\": \"%s\", \"rows\": %d, \"cols\": %d, ", file.filename().string().c_str(), size, size);
+				if (density >= 0) std::printf("\"density\": %.2f, ", density);
+				else std::printf("\"density\": \"file\", ");
+				std::printf("\"population\": %d, \"generations\": %zu, \"seconds\": %.6f, ", population, latencies.size(), seconds);
+				std::printf("\"generations_per_second\": %.2f, \"cells_per_second\": %.0f, ", perSecond, perSecond * size * size);
+				std::printf("\"latency_us\": { \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f }, ",
+					GetPercentile(latencies, 0.5), GetPercentile(latencies, 0.9), GetPercentile(latencies, 0.99), latencies.size() ? latencies.back() : 0.0);
+				std::printf("\"hash\": \"%016llx\" }", cells.GetHash());
+
+				std::fflush(stdout);
+			}
+		}
+	}
+
+	// the runs share the process, so this is only the largest of them
+	std::printf("\n\t],\n\t\"peak_rss_kb\": %lld\n}\n", GetPeakMemory());
+
+	return 0;
+}
@@ -0,0 +1,78 @@
+// runs a pattern file for a number of generations without opening a window:
+//     Headless <pattern file> <generations> [threads]
+// built on its own, next to Automaton, PatternFile, Interpreter, StateRegistry,
+// Universe, RuleEngine (and the classes it runs on) and ThreadPool (no wxWidgets needed)
+
+#include "../Automaton.h"
+#include "../PatternFile.h"
+
+#include <cstdio>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::fprintf(stderr, "Usage: %s <pattern file> <generations> [threads]\n", argv[0]);
+		return 1;
+	}
+
+	std::ifstream in(argv[1], std::ios::binary);
+	if (!in)
+	{
+		std::fprintf(stderr, "Can't open %s\n", argv[1]);
+		return 1;
+	}
+
+	std::stringstream text;
+	text << in.rdbuf();
+
+	auto file = PatternFile::Read(text.str());
+	for (auto& error : file.second)
+	{
+		std::fprintf(stderr, "%s: line %d: %s\n", argv[1], error.first, error.second.c_str());
+	}
+	if (file.second.size()) return 1;
+
+	long long generations = std::stoll(argv[2]);
+	int threads = argc > 3 ? std::stoi(argv[3]) : 0;
+
+	Automaton automaton(threads);
+
+	std::string error = automaton.Load(file.first);
+	if (error.size())
+	{
+		std::fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+		return 1;
+	}
+
+	Universe& cells = automaton.GetCells();
+
+	std::printf("generation\tmicroseconds\tchanges\tpopulation\n");
+
+	long long generation = 0;
+	double total = 0;
+
+	while (generation < generations)
+	{
+		auto start = std::chrono::steady_clock::now();
+		bool changed = automaton.Step();
+		auto end = std::chrono::steady_clock::now();
+
+		double elapsed = std::chrono::duration<double, std::micro>(end - start).count();
+		total += elapsed;
+		generation++;
+
+		std::printf("%lld\t%.1f\t%zu\t%d\n", generation, elapsed, automaton.GetChanges().size(), cells.GetPopulation());
+
+		// universe has come to an end
+		if (!changed) break;
+	}
+
+	std::printf("generations=%lld seconds=%.6f population=%d hash=%016llx\n", generation, total * 1e-6, cells.GetPopulation(), cells.GetHash());
+
+	return 0;
+}